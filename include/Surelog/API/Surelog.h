@@ -28,6 +28,9 @@
 // UHDM
 #include <uhdm/sv_vpi_user.h>
 
+#include <cstdint>
+#include <string_view>
+
 namespace SURELOG {
 
 class CommandLineParser;
@@ -47,13 +50,24 @@ Design* get_design(scompiler* compiler);
 //      third_party/UHDM/headers/
 vpiHandle get_uhdm_design(scompiler* compiler);
 
+// With -lazyelabuhdm the UHDM design is kept folded, the subtree of a top
+// level instance is fully elaborated the first time it is requested here.
+// Returns the top level instance handle, 0 if none is named "topName".
+vpiHandle get_uhdm_elaborated_top(scompiler* compiler,
+                                  std::string_view topName);
+
 // Terminate the compiler session, cleanup internal datastructures,
 // Purges UHDM and VPI from memory,
 // this invalidates any UHDM/VPI pointers the client application might still
 // use!
 void shutdown_compiler(scompiler* compiler);
 
-void walk_ast(scompiler* compiler, AstListener* listener);
+// Walks the AST of every compiled file with the listener. With nbThreads > 1
+// and a listener implementing AstListener::clone(), the files are spread
+// over worker threads listening with their own clone. The clones are joined
+// back into the listener and deleted once all files were walked.
+void walk_ast(scompiler* compiler, AstListener* listener,
+              uint32_t nbThreads = 1);
 
 }  // namespace SURELOG
 
@@ -29,6 +29,7 @@
 #include <Surelog/Common/PathId.h>
 #include <flatbuffers/flatbuffers.h>
 
+#include <memory>
 #include <string_view>
 #include <vector>
 
@@ -63,6 +64,10 @@ class Cache {
 
   // Open file and read contents into a buffer.
   bool openFlatBuffers(PathId cacheFileId, std::vector<char>& content) const;
+  // Same, the caches of precompiled packages are shared images, released
+  // once no check or restore uses them (see Precompiled::loadImage).
+  bool openFlatBuffers(PathId cacheFileId, bool isPrecompiled,
+                       std::shared_ptr<const std::vector<char>>& content) const;
 
   bool saveFlatbuffers(const flatbuffers::FlatBufferBuilder& builder,
                        PathId cacheFileId, SymbolTable* symbolTable);
@@ -0,0 +1,65 @@
+/*
+ Copyright 2019 Alain Dargelas
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef SURELOG_DFACACHE_H
+#define SURELOG_DFACACHE_H
+#pragma once
+
+#include <Surelog/Cache/Cache.h>
+
+#include <cstdint>
+#include <string_view>
+
+namespace antlr4 {
+class Parser;
+}  // namespace antlr4
+
+namespace SURELOG {
+
+class CommandLineParser;
+
+// Persists the prediction DFA learned by an ANTLR parser so that the next
+// run starts with a warm parser (-dfacache <dir>).
+// The DFA is shared by all the instances of a generated parser class, so any
+// instance can be used to restore or save it. Neither call is thread safe
+// with respect to a running parse: restore before parsing, save after.
+class DFACache : Cache {
+ public:
+  DFACache(CommandLineParser* clp, SymbolTable* symbolTable);
+
+  // "grammar" is the name of the cache file (ie: SV3_1aParser).
+  bool restore(antlr4::Parser* parser, std::string_view grammar);
+  bool save(antlr4::Parser* parser, std::string_view grammar);
+
+  // Number of DFA states restored or saved by the last call.
+  uint64_t getStateCount() const { return m_stateCount; }
+
+ private:
+  DFACache(const DFACache& orig) = delete;
+
+  PathId getCacheFileId_(std::string_view grammar) const;
+  bool checkCacheIsValid_(antlr4::Parser* parser, std::string_view grammar,
+                          const std::vector<char>& content) const;
+  bool restore_(antlr4::Parser* parser, const std::vector<char>& content);
+
+  CommandLineParser* const m_commandLineParser = nullptr;
+  SymbolTable* const m_symbolTable = nullptr;
+  uint64_t m_stateCount = 0;
+};
+
+}  // namespace SURELOG
+
+#endif /* SURELOG_DFACACHE_H */
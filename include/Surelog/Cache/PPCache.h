@@ -48,6 +48,8 @@ class PPCache : Cache {
   bool checkCacheIsValid_(PathId cacheFileId) const;
   bool checkCacheIsValid_(PathId cacheFileId,
                           const std::vector<char>& content) const;
+  // Whether the cache is the image of a precompiled package
+  bool isPrecompiled_() const;
 
   PreprocessFile* const m_pp = nullptr;
 };
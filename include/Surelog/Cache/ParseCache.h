@@ -36,6 +36,9 @@ class ParseCache : Cache {
   ParseCache(ParseFile* pp);
 
   bool restore();
+  // -diffcompunit: reuse the parse of the file unit compilation when the
+  // file preprocessed to the same text under both semantics.
+  bool restoreFromFileUnit();
   bool save();
   bool isValid();
 
@@ -47,6 +50,8 @@ class ParseCache : Cache {
   bool checkCacheIsValid_(PathId cacheFileId) const;
   bool checkCacheIsValid_(PathId cacheFileId,
                           const std::vector<char>& content) const;
+  // Whether the cache is the image of a precompiled package
+  bool isPrecompiled_() const;
 
   ParseFile* const m_parse = nullptr;
 };
@@ -70,6 +70,8 @@ class CommandLineParser final {
     return m_fileUnit;
   }  // File or all compilation semantic
   void setFileUnit() { m_fileUnit = true; }
+  // -diffcompunit, the file unit compilation runs first
+  bool diffCompMode() const { return m_diffCompMode; }
   /* PP Output file/dir options */
   PathId writePpOutputFileId() const { return m_writePpOutputFileId; }
   PathId getOutputDirId() const { return m_outputDirId; }
@@ -90,6 +92,7 @@ class CommandLineParser final {
   void setCacheAllowed(bool val) { m_cacheAllowed = val; }
   bool lineOffsetsAsComments() const { return m_lineOffsetsAsComments; }
   PathId getCacheDirId() const { return m_cacheDirId; }
+  PathId getDfaCacheDirId() const { return m_dfaCacheDirId; }
   PathId getPrecompiledDirId() const { return m_precompiledDirId; }
   bool usePPOutputFileLocation() const { return m_ppOutputFileLocation; }
   /* PP Output content generation options */
@@ -119,6 +122,7 @@ class CommandLineParser final {
   bool getDebugUhdm() const { return m_dumpUhdm; }
   bool getUhdmStats() const { return m_uhdmStats; }
   bool getElabUhdm() const { return m_elabUhdm; }
+  bool lazyElabUhdm() const { return m_lazyElabUhdm; }
   bool getCoverUhdm() const { return m_coverUhdm; }
   bool getParametersSubstitution() const { return m_parametersubstitution; }
   bool getLetExprSubstitution() const { return m_letexprsubstitution; }
@@ -135,14 +139,22 @@ class CommandLineParser final {
   bool parse() const { return m_parse; }
   bool parseOnly() const { return m_parseOnly; }
   bool lowMem() const { return m_lowMem; }
+  bool boundedMem() const { return m_boundedMem; }
+  unsigned int getMaxTokenizedFiles() const { return m_maxTokenizedFiles; }
+  bool speculativePreprocess() const { return m_speculativePreprocess; }
+  bool macroExpander() const { return m_macroExpander; }
   bool compile() const { return m_compile; }
   bool elaborate() const { return m_elaborate; }
   bool writeUhdm() const { return m_writeUhdm; }
+  // The UHDM writer late-binds the references of a definition once, with
+  // its first instance. Off, it binds them again for every instance.
+  bool lateBindPerDefinition() const { return m_lateBindPerDefinition; }
   bool sepComp() const { return m_sepComp; }
   bool link() const { return m_link; }
   void setParse(bool val) { m_parse = val; }
   void setParseOnly(bool val) { m_parseOnly = val; }
   void setLowMem(bool val) { m_lowMem = val; }
+  void setMacroExpander(bool val) { m_macroExpander = val; }
   void setCompile(bool val) { m_compile = val; }
   void setElaborate(bool val) { m_elaborate = val; }
   void setSepComp(bool val) {
@@ -152,6 +164,7 @@ class CommandLineParser final {
     m_compile = false;
     m_elaborate = false;
     m_elabUhdm = false;
+    m_lazyElabUhdm = false;
     m_writeUhdm = false;
     m_parseBuiltIn = false;
   }
@@ -169,6 +182,7 @@ class CommandLineParser final {
   void setDebugUhdm(bool val) { m_dumpUhdm = val; }
   void setCoverUhdm(bool val) { m_coverUhdm = val; }
   void setWriteUhdm(bool val) { m_writeUhdm = val; }
+  void setLateBindPerDefinition(bool val) { m_lateBindPerDefinition = val; }
   void showVpiIds(bool val) { m_showVpiIDs = val; }
   void setDebugAstModel(bool val) { m_debugAstModel = val; }
   void setParametersSubstitution(bool val) { m_parametersubstitution = val; }
@@ -307,6 +321,7 @@ class CommandLineParser final {
   PathId m_compileAllDirId;
   PathId m_outputDirId;
   PathId m_cacheDirId;
+  PathId m_dfaCacheDirId;
   PathId m_precompiledDirId;
   bool m_note;
   bool m_info;
@@ -337,12 +352,18 @@ class CommandLineParser final {
   bool m_sverilog;
   bool m_dumpUhdm;
   bool m_elabUhdm;
+  bool m_lazyElabUhdm;
   bool m_coverUhdm;
   bool m_showVpiIDs;
   bool m_replay;
   bool m_uhdmStats;
   bool m_lowMem;
+  bool m_boundedMem;
+  unsigned int m_maxTokenizedFiles;
+  bool m_speculativePreprocess;
+  bool m_macroExpander;
   bool m_writeUhdm;
+  bool m_lateBindPerDefinition;
   bool m_nonSynthesizable;
   bool m_nonSynthesizableWithFormal;
   bool m_noCacheHash;
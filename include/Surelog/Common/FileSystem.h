@@ -297,6 +297,11 @@ class FileSystem {
   virtual PathId locate(std::string_view name, const PathIdVector &directories,
                         SymbolTable *symbolTable) = 0;
 
+  // Implementations may index the searched directories for the duration of
+  // a run. Drops that index, for when directories changed behind the back
+  // of the file system (e.g. between runs of a long running process).
+  virtual void invalidateLocateCache() {}
+
   // Returns a list of all files under the input 'dirId'.
   virtual PathIdVector &collect(PathId dirId, SymbolTable *symbolTable,
                                 PathIdVector &container) = 0;
@@ -27,9 +27,14 @@
 
 #include <Surelog/Common/FileSystem.h>
 
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace SURELOG {
 class SymbolTable;
@@ -146,6 +151,7 @@ class PlatformFileSystem : public FileSystem {
 
   PathId locate(std::string_view name, const PathIdVector &directories,
                 SymbolTable *symbolTable) override;
+  void invalidateLocateCache() override;
 
   PathIdVector &collect(PathId dirId, SymbolTable *symbolTable,
                         PathIdVector &container) override;
@@ -230,6 +236,34 @@ class PlatformFileSystem : public FileSystem {
   std::filesystem::path m_outputDir;
 
  private:
+  // Entries of a directory, searched by locate() instead of probing the
+  // file system once per candidate directory.
+  struct DirectoryListing final {
+    bool m_indexed = false;  // false when the directory couldn't be listed
+    std::unordered_set<std::string> m_names;
+  };
+
+  // Directories searched by locate(), interned so that the cached results
+  // don't repeat the directories for every name.
+  struct SearchPath final {
+    std::vector<std::string> m_directories;  // As passed to locate()
+    std::vector<std::string> m_normalized;   // Keys of m_directoryListings
+    // Keyed by name, empty value when not found
+    std::map<std::string, std::string, std::less<>> m_results;
+  };
+
+  // Called by the operations that add or remove the entry 'path'
+  void invalidateEntry_(const std::filesystem::path &path);
+  // Expect m_locateMutex to be held
+  const DirectoryListing &getDirectoryListing_(const std::string &dirpath);
+  SearchPath &getSearchPath_(const PathIdVector &directories);
+
+  std::mutex m_locateMutex;
+  // Keyed by normalized directory path
+  std::unordered_map<std::string, DirectoryListing> m_directoryListings;
+  // Keyed by the hash of the directories
+  std::unordered_multimap<size_t, SearchPath> m_searchPaths;
+
   PlatformFileSystem(const PlatformFileSystem &rhs) = delete;
   PlatformFileSystem &operator=(const PlatformFileSystem &rhs) = delete;
 };
@@ -26,9 +26,11 @@
 #pragma once
 
 #include <Surelog/Common/NodeId.h>
+#include <Surelog/Common/SymbolId.h>
 
 #include <map>
 #include <string>
+#include <string_view>
 
 namespace SURELOG {
 
@@ -37,7 +39,10 @@ class Value;
 
 class DefParam final {
  public:
-  DefParam(const std::string& name, DefParam* parent = nullptr)
+  // Children are keyed by the symbol id of their path component
+  typedef std::map<SymbolId, DefParam*, SymbolIdLessThanComparer> DefParamMap;
+
+  DefParam(std::string_view name, DefParam* parent = nullptr)
       : m_name(name),
         m_value(nullptr),
         m_used(false),
@@ -46,13 +51,15 @@ class DefParam final {
 
   DefParam(const DefParam& orig) = delete;
 
+  const std::string& getName() const { return m_name; }
   Value* getValue() const { return m_value; }
   void setValue(Value* value) { m_value = value; }
 
-  void setChild(std::string name, DefParam* child) {
-    m_children.emplace(name, child);
+  void setChild(SymbolId nameId, DefParam* child) {
+    m_children.emplace(nameId, child);
   }
-  std::map<std::string, DefParam*>& getChildren() { return m_children; }
+  DefParamMap& getChildren() { return m_children; }
+  const DefParamMap& getChildren() const { return m_children; }
   bool isUsed() const { return m_used; }
   void setUsed() { m_used = true; }
   void setLocation(const FileContent* fC, NodeId nodeId) {
@@ -66,7 +73,7 @@ class DefParam final {
 
  private:
   const std::string m_name;
-  std::map<std::string, DefParam*> m_children;
+  DefParamMap m_children;
   Value* m_value;
   bool m_used;
   DefParam* m_parent;
@@ -28,9 +28,12 @@
 #include <Surelog/Common/Containers.h>
 #include <Surelog/Common/NodeId.h>
 #include <Surelog/Common/PathId.h>
+#include <Surelog/Design/DefParam.h>
+#include <Surelog/Utils/TypedArena.h>
 
 #include <map>
 #include <mutex>
+#include <string_view>
 #include <vector>
 
 namespace SURELOG {
@@ -41,21 +44,25 @@ class Builtin;
 class CompileDesign;
 class Compiler;
 class ConfigSet;
-class DefParam;
+class DataType;
 class DesignComponent;
 class DesignElaboration;
 class ErrorContainer;
 class FileContent;
 class LibrarySet;
 class ModuleInstance;
+class Parameter;
 class ParseCache;
 class ParseFile;
 class PPCache;
 class PreprocessFile;
 class SV3_1aPpTreeShapeListener;
 class SV3_1aTreeShapeListener;
+class Signal;
 class SVLibShapeListener;
+class SymbolTable;
 class Value;
+class Variable;
 
 class Design final {
   friend class AnalyzeFile;
@@ -136,9 +143,14 @@ class Design final {
 
   DefParam* getDefParam(const std::string& name) const;
 
+  // Defparam on parameter 'name' of 'instance', matched on the ids of the
+  // instance chain without building its path
+  DefParam* getDefParam(const ModuleInstance* instance,
+                        std::string_view name) const;
+
   Value* getDefParamValue(const std::string& name);
 
-  std::map<std::string, DefParam*>& getDefParams() { return m_defParams; }
+  DefParam::DefParamMap& getDefParams() { return m_defParams; }
 
   void checkDefParamUsage(DefParam* parent = nullptr);
 
@@ -164,6 +176,16 @@ class Design final {
 
   void addBindStmt(const std::string& targetName, BindStmt* stmt);
 
+  // Design model objects that no container owns are allocated from these
+  // arenas, they are all released with the design (shutdown_compiler).
+  TypedArena<Signal>& getSignalArena() { return m_signalArena; }
+  TypedArena<Variable>& getVariableArena() { return m_variableArena; }
+  TypedArena<Parameter>& getParameterArena() { return m_parameterArena; }
+  TypedArena<DataType>& getDataTypeArena() { return m_dataTypeArena; }
+
+  // For -profile
+  std::string getArenaProfileInfo() const;
+
  protected:
   // Thread-safe
   void addFileContent(PathId fileId, FileContent* content);
@@ -171,6 +193,9 @@ class Design final {
   // Thread-safe
   void addPPFileContent(PathId fileId, FileContent* content);
 
+  // Deletes the preprocessor file contents built against symbolTable
+  void removePPFileContents(const SymbolTable* symbolTable);
+
   void addOrderedPackage(const std::string& packageName) {
     m_orderedPackageNames.push_back(packageName);
   }
@@ -223,7 +248,7 @@ class Design final {
 
   std::vector<ModuleInstance*> m_topLevelModuleInstances;
 
-  std::map<std::string, DefParam*> m_defParams;
+  DefParam::DefParamMap m_defParams;
 
   PackageNamePackageDefinitionMultiMap m_packageDefinitions;
 
@@ -239,6 +264,11 @@ class Design final {
 
   BindMap m_bindMap;
 
+  TypedArena<Signal> m_signalArena;
+  TypedArena<Variable> m_variableArena;
+  TypedArena<Parameter> m_parameterArena;
+  TypedArena<DataType> m_dataTypeArena;
+
   std::mutex m_mutex;
 };
 
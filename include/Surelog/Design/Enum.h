@@ -25,6 +25,7 @@
 #define SURELOG_ENUM_H
 #pragma once
 
+#include <Surelog/Common/Containers.h>
 #include <Surelog/Common/SymbolId.h>
 #include <Surelog/Design/DataType.h>
 
@@ -33,6 +34,7 @@
 
 #include <map>
 #include <string>
+#include <string_view>
 
 namespace SURELOG {
 
@@ -45,12 +47,14 @@ class Enum : public DataType {
   Enum(const FileContent* fC, NodeId nameId, NodeId baseTypeId);
   ~Enum() override = default;
 
-  typedef std::map<std::string, std::pair<unsigned int, Value*>> NameValueMap;
+  typedef std::map<std::string, std::pair<unsigned int, Value*>,
+                   StringViewCompare>
+      NameValueMap;
 
   void addValue(const std::string& name, unsigned int lineNb, Value* value) {
     m_values.emplace(name, std::make_pair(lineNb, value));
   }
-  Value* getValue(const std::string& name) const;
+  Value* getValue(std::string_view name) const;
   NodeId getDefinitionId() const { return m_nameId; }
   NameValueMap& getValues() { return m_values; }
 
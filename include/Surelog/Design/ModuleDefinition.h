@@ -57,22 +57,23 @@ class ModuleDefinition : public DesignComponent, public ClockingBlockHolder {
   bool isInstance() const override;
   unsigned int getSize() const override;
 
-  typedef std::map<std::string, ClockingBlock> ClockingBlockMap;
-  typedef std::map<std::string, ModPort> ModPortSignalMap;
-  typedef std::map<std::string, std::vector<ClockingBlock>>
+  typedef std::map<std::string, ClockingBlock, StringViewCompare>
+      ClockingBlockMap;
+  typedef std::map<std::string, ModPort, StringViewCompare> ModPortSignalMap;
+  typedef std::map<std::string, std::vector<ClockingBlock>, StringViewCompare>
       ModPortClockingBlockMap;
 
   ModPortSignalMap& getModPortSignalMap() { return m_modportSignalMap; }
   ModPortClockingBlockMap& getModPortClockingBlockMap() {
     return m_modportClockingBlockMap;
   }
-  void insertModPort(const std::string& modport, const Signal& signal,
+  void insertModPort(std::string_view modport, const Signal& signal,
                      NodeId nodeId);
-  void insertModPort(const std::string& modport, ClockingBlock& block);
-  const Signal* getModPortSignal(const std::string& modport, NodeId port) const;
-  ModPort* getModPort(const std::string& modport);
+  void insertModPort(std::string_view modport, ClockingBlock& block);
+  const Signal* getModPortSignal(std::string_view modport, NodeId port) const;
+  ModPort* getModPort(std::string_view modport);
 
-  const ClockingBlock* getModPortClockingBlock(const std::string& modport,
+  const ClockingBlock* getModPortClockingBlock(std::string_view modport,
                                                NodeId port) const;
 
   ClassNameClassDefinitionMultiMap& getClassDefinitions() {
@@ -82,7 +83,7 @@ class ModuleDefinition : public DesignComponent, public ClockingBlockHolder {
                           ClassDefinition* classDef) {
     m_classDefinitions.emplace(className, classDef);
   }
-  ClassDefinition* getClassDefinition(const std::string& name);
+  ClassDefinition* getClassDefinition(std::string_view name);
 
   void setGenBlockId(NodeId id) { m_gen_block_id = id; }
   NodeId getGenBlockId() const { return m_gen_block_id; }
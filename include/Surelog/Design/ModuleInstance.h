@@ -48,7 +48,8 @@ class ModuleInstance : public ValuedComponentI {
  public:
   ModuleInstance(DesignComponent* definition, const FileContent* fileContent,
                  NodeId nodeId, ModuleInstance* parent,
-                 std::string_view instName, std::string_view moduleName);
+                 std::string_view instName, std::string_view moduleName,
+                 SymbolTable* symbols);
   ~ModuleInstance() override;
 
   typedef std::map<UHDM::module_array*, std::vector<ModuleInstance*>>
@@ -86,8 +87,14 @@ class ModuleInstance : public ValuedComponentI {
   SymbolId getFullPathId(SymbolTable* symbols) const;
   SymbolId getInstanceId(SymbolTable* symbols) const;
   SymbolId getModuleNameId(SymbolTable* symbols) const;
-  std::string getInstanceName() const;
-  std::string getFullPathName() const;
+  SymbolId getInstanceNameId() const { return m_instNameId; }
+  const std::string& getInstanceName() const;
+  // Built once, on first request, from the parent's path and interned in
+  // the symbol table. Reparenting invalidates it.
+  const std::string& getFullPathName() const;
+  // Compares the dot separated path to the instance chain, leaf first, on
+  // symbol ids. No path string is built.
+  bool matchesFullPathName(std::string_view path) const;
   std::string_view getModuleName() const;
   unsigned int getDepth() const;
 
@@ -116,13 +123,17 @@ class ModuleInstance : public ValuedComponentI {
   ModuleInstance* getChildByName(std::string_view name);
 
  private:
+  void invalidateFullPathName_();
+
   DesignComponent* m_definition;
   std::vector<ModuleInstance*> m_allSubInstances;
   const FileContent* m_fileContent;
   NodeId m_nodeId;
   ModuleInstance* m_parent;
-  std::string m_instName;  // Can carry the moduleName@instanceName if the
-                           // module is undefined
+  SymbolTable* const m_symbols;
+  SymbolId m_instNameId;
+  SymbolId m_moduleNameId;  // Only set if the module is undefined
+  mutable SymbolId m_fullPathId;  // Set by getFullPathName()
   std::vector<Parameter*> m_typeParams;
   Netlist* m_netlist;
   ModuleInstance* m_boundInstance = nullptr;
@@ -133,11 +144,16 @@ class ModuleInstance : public ValuedComponentI {
 
 class ModuleInstanceFactory {
  public:
+  explicit ModuleInstanceFactory(SymbolTable* symbols) : m_symbols(symbols) {}
+
   ModuleInstance* newModuleInstance(DesignComponent* definition,
                                     const FileContent* fileContent,
                                     NodeId nodeId, ModuleInstance* parent,
                                     std::string_view instName,
                                     std::string_view moduleName);
+
+ private:
+  SymbolTable* const m_symbols;
 };
 
 }  // namespace SURELOG
@@ -25,6 +25,8 @@
 #define SURELOG_NETLIST_H
 #pragma once
 
+#include <Surelog/Common/Containers.h>
+
 // UHDM
 #include <uhdm/uhdm_forward_decl.h>
 
@@ -42,10 +44,14 @@ class Netlist {
   Netlist(ModuleInstance* parent) : m_parent(parent) {}
   ~Netlist();
 
-  typedef std::map<std::string, std::pair<ModPort*, UHDM::modport*>> ModPortMap;
-  typedef std::map<std::string, std::pair<ModuleInstance*, UHDM::BaseClass*>>
+  typedef std::map<std::string, std::pair<ModPort*, UHDM::modport*>,
+                   StringViewCompare>
+      ModPortMap;
+  typedef std::map<std::string, std::pair<ModuleInstance*, UHDM::BaseClass*>,
+                   StringViewCompare>
       InstanceMap;
-  typedef std::map<std::string, UHDM::BaseClass*> SymbolTable;
+  typedef std::map<std::string, UHDM::BaseClass*, StringViewCompare>
+      SymbolTable;
 
   std::vector<UHDM::interface*>* interfaces() { return m_interfaces; }
   std::vector<UHDM::interface_array*>* interface_arrays() {
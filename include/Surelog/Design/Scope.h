@@ -25,10 +25,12 @@
 #define SURELOG_SCOPE_H
 #pragma once
 
+#include <Surelog/Common/Containers.h>
 #include <Surelog/Common/RTTI.h>
 
-#include <string>
 #include <map>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace SURELOG {
@@ -40,8 +42,8 @@ class Variable;
 class Scope : public RTTI {
   SURELOG_IMPLEMENT_RTTI(Scope, RTTI)
  public:
-  typedef std::map<std::string, Variable*> VariableMap;
-  typedef std::map<std::string, DataType*> DataTypeMap;
+  typedef std::map<std::string, Variable*, StringViewCompare> VariableMap;
+  typedef std::map<std::string, DataType*, StringViewCompare> DataTypeMap;
   typedef std::vector<Statement*> StmtVector;
   typedef std::vector<Scope*> ScopeVector;
 
@@ -55,10 +57,10 @@ class Scope : public RTTI {
   void addVariable(Variable* var);
 
   VariableMap& getVariables() { return m_variables; }
-  Variable* getVariable(const std::string& name);
+  Variable* getVariable(std::string_view name);
 
   DataTypeMap& getUsedDataTypeMap() { return m_usedDataTypes; }
-  DataType* getUsedDataType(const std::string& name);
+  DataType* getUsedDataType(std::string_view name);
   void insertUsedDataType(const std::string& dataTypeName, DataType* dataType) {
     m_usedDataTypes.emplace(dataTypeName, dataType);
   }
@@ -32,9 +32,16 @@
 #include <uhdm/sv_vpi_user.h>
 
 #include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
 
 namespace SURELOG {
 
+namespace UHDM {
+class module;
+}  // namespace UHDM
+
 class Compiler;
 class SymbolTable;
 class ValuedComponentI;
@@ -51,6 +58,11 @@ class CompileDesign {
   bool elaborate();
   vpiHandle writeUHDM(PathId fileId);
 
+  // -lazyelabuhdm: fully elaborates the UHDM subtree of the top level
+  // instance "topName" the first time it is requested. Returns the top level
+  // instance, nullptr if there is none by that name.
+  UHDM::module* elaborateUhdmTop(std::string_view topName);
+
   Compiler* getCompiler() const { return m_compiler; }
   virtual UHDM::Serializer& getSerializer() { return m_serializer; }
   void lockSerializer() { m_serializerMutex.lock(); }
@@ -73,6 +85,7 @@ class CompileDesign {
 
   std::mutex m_serializerMutex;
   UHDM::Serializer m_serializer;
+  std::set<std::string, std::less<>> m_elaboratedUhdmTops;
 };
 
 }  // namespace SURELOG
@@ -127,6 +127,7 @@ class CompileHelper final {
 
   bool compileAnsiPortDeclaration(DesignComponent* component,
                                   const FileContent* fC, NodeId id,
+                                  CompileDesign* compileDesign,
                                   VObjectType& port_direction);
 
   bool compileNetDeclaration(DesignComponent* component, const FileContent* fC,
@@ -31,6 +31,7 @@
 // UHDM
 #include <uhdm/uhdm_forward_decl.h>
 
+#include <set>
 #include <string>
 
 namespace SURELOG {
@@ -113,6 +114,10 @@ class UhdmWriter final {
                         DesignComponent* mod, UHDM::any* scope,
                         std::vector<UHDM::cont_assign*>* assigns);
 
+  // True if the late bindings of the definition are still to be done: with
+  // its first instance, or with every instance when lateBindPerDefinition()
+  // is off.
+  bool lateBindingDue(DesignComponent* mod);
   void lateBinding(UHDM::Serializer& s, DesignComponent* mod, UHDM::scope* m,
                    UhdmWriter::ComponentMap& componentMap);
   void lateTypedefBinding(UHDM::Serializer& s, DesignComponent* mod,
@@ -122,6 +127,10 @@ class UhdmWriter final {
   CompileDesign* const m_compileDesign;
   Design* const m_design;
   CompileHelper m_helper;
+  // Definitions whose late bindings are done. The references are shared by
+  // all the instances of a definition, so they are bound once, with its
+  // first instance.
+  std::set<DesignComponent*> m_lateBoundComponents;
 };
 
 }  // namespace SURELOG
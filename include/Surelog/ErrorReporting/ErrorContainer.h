@@ -86,6 +86,8 @@ class ErrorContainer final {
 
   std::pair<std::string, bool> createReport_() const;
   std::pair<std::string, bool> createReport_(const Error& error) const;
+  // Severity filtering (-nowarning, -noinfo, -nonote) without formatting
+  bool isFiltered_(ErrorDefinition::ErrorType type) const;
   std::vector<Error> m_errors;
   std::set<std::string> m_errorSet;
 
@@ -84,6 +84,7 @@ class ErrorDefinition {
     CMD_WD_MISSING_DIR = 31,
     CMD_CD_MISSING_DIR = 32,
     CMD_REMAP_MISSING_DIRS = 33,
+    CMD_BOUNDEDMEM_MISSING_SIZE = 34,
     PP_CANNOT_OPEN_FILE = 100,
     PP_CANNOT_OPEN_INCLUDE_FILE = 101,
     PP_UNKOWN_MACRO = 102,
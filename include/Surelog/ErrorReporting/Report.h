@@ -25,6 +25,10 @@
 #define SURELOG_REPORT_H
 #pragma once
 
+#include <Surelog/ErrorReporting/ErrorContainer.h>
+
+#include <set>
+#include <string>
 #include <utility>
 
 namespace SURELOG {
@@ -34,9 +38,23 @@ class SymbolTable;
 
 class Report final {
  public:
+  // Outcome of one of the two compilations of -diffcompunit
+  struct Result {
+    ErrorContainer::Stats m_stats;
+    std::set<std::string> m_messages;
+  };
+
   Report() = default;
+
+  // Records the stats and the (formatted, unwaived) messages of "errors"
+  static void collectResult(const ErrorContainer* errors, Result& result);
+
+  // Compares the file unit and all files compilations, "clp" and "st" are the
+  // ones of the all files compilation.
   std::pair<bool, bool> makeDiffCompUnitReport(CommandLineParser* clp,
-                                               SymbolTable* st);
+                                               SymbolTable* st,
+                                               const Result& unitResult,
+                                               const Result& allResult);
 
  private:
   Report(const Report& orig) = delete;
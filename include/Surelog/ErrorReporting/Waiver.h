@@ -27,10 +27,13 @@
 
 #include <Surelog/ErrorReporting/ErrorDefinition.h>
 
+#include <cstdint>
 #include <map>
 #include <set>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace SURELOG {
 
@@ -44,6 +47,9 @@ class Waiver final {
                         const std::string& fileName, unsigned int line,
                         const std::string& objectName);
 
+  // Removes every waiver set so far
+  static void clearWaivers();
+
   class WaiverData {
    public:
     WaiverData(ErrorDefinition::ErrorType messageId, std::string_view fileName,
@@ -58,16 +64,55 @@ class Waiver final {
     const std::string m_objectId;
   };
 
-  static std::multimap<ErrorDefinition::ErrorType, WaiverData>& getWaivers() {
-    return m_waivers;
+  // Cheap pre-check, lets callers skip gathering the message location
+  static bool hasWaivers(ErrorDefinition::ErrorType messageId) {
+    return m_waivedTypes.find(messageId) != m_waivedTypes.end();
   }
 
+  // Empty fileName, null line or empty objectName in a waiver match anything.
+  // Exact waivers are looked up in a hash index, waivers with glob patterns
+  // (*, ?) in the file or object name are matched separately.
+  static bool isWaived(ErrorDefinition::ErrorType messageId,
+                       std::string_view fileName, unsigned int line,
+                       std::string_view objectName);
+
+  static bool globMatch(std::string_view pattern, std::string_view text);
+
  private:
   Waiver() = delete;
   Waiver(const Waiver& orig) = delete;
 
+  struct WaiverKey {
+    ErrorDefinition::ErrorType m_messageId;
+    uint32_t m_fileName;  // Index in m_waiverStrings, 0 is any
+    unsigned int m_line;  // 0 is any
+    uint32_t m_objectId;  // Index in m_waiverStrings, 0 is any
+    bool operator==(const WaiverKey& rhs) const {
+      return (m_messageId == rhs.m_messageId) &&
+             (m_fileName == rhs.m_fileName) && (m_line == rhs.m_line) &&
+             (m_objectId == rhs.m_objectId);
+    }
+  };
+  struct WaiverKeyHash {
+    size_t operator()(const WaiverKey& key) const {
+      size_t h = std::hash<unsigned int>()(key.m_messageId);
+      h = (h * 31) + key.m_fileName;
+      h = (h * 31) + key.m_line;
+      h = (h * 31) + key.m_objectId;
+      return h;
+    }
+  };
+
+  static uint32_t internWaiverString_(std::string_view str);
+  static uint32_t getWaiverString_(std::string_view str);
+
   static std::set<std::string> m_macroArgCheck;
-  static std::multimap<ErrorDefinition::ErrorType, WaiverData> m_waivers;
+  static std::unordered_set<ErrorDefinition::ErrorType> m_waivedTypes;
+  // Names of the exact waivers, views are over the nodes of the storage set
+  static std::set<std::string, std::less<>> m_waiverStringStorage;
+  static std::unordered_map<std::string_view, uint32_t> m_waiverStrings;
+  static std::unordered_set<WaiverKey, WaiverKeyHash> m_exactWaivers;
+  static std::multimap<ErrorDefinition::ErrorType, WaiverData> m_globWaivers;
 };
 
 }  // namespace SURELOG
@@ -25,10 +25,14 @@
 #define SURELOG_PRECOMPILED_H
 #pragma once
 
+#include <filesystem>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace SURELOG {
 class PathId;
@@ -47,12 +51,26 @@ class Precompiled final {
 
   bool isPackagePrecompiled(std::string_view packageName) const;
 
+  // Content of a precompiled package cache file. The image is shared by all
+  // the concurrent users (validity check and restore) and released once the
+  // last one drops it, it is not kept for the rest of the process. It is
+  // read again when the file on disk changed. nullptr when the file can't be
+  // read.
+  std::shared_ptr<const std::vector<char>> loadImage(PathId imageFileId);
+
  private:
   Precompiled();  // Only accessed via singleton.
   Precompiled(const Precompiled&) = delete;
 
   std::map<std::string, std::string, std::less<>> m_packageMap;
   std::set<std::string, std::less<>> m_packageFileSet;
+
+  struct Image final {
+    std::filesystem::file_time_type m_modtime;
+    std::weak_ptr<const std::vector<char>> m_content;
+  };
+  std::mutex m_imageMutex;
+  std::map<std::string, Image, std::less<>> m_images;
 };
 
 }  // namespace SURELOG
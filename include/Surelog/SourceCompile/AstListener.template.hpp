@@ -33,7 +33,6 @@
 
 #include <cstdint>
 #include <type_traits>
-#include <unordered_set>
 #include <vector>
 
 namespace SURELOG {
@@ -88,8 +87,6 @@ struct AstNodeHash final {
 
 class AstListener {
  protected:
-  typedef std::unordered_set<AstNode, AstNodeHash, AstNodeEqualityComparer>
-      astnode_set_t;
   typedef std::vector<AstNode> astnode_stack_t;
   typedef std::vector<AstNode> astnode_vector_t;
 
@@ -100,6 +97,13 @@ class AstListener {
   virtual void enterSourceFile(PathId fileId) {}
   virtual void leaveSourceFile(PathId fileId) {}
 
+  // Lets walk_ast listen to several files in parallel: clone() returns a
+  // fresh listener for a worker thread (nullptr, the default, keeps the walk
+  // serial) and join() folds the state of a worker back into this listener
+  // once all files were walked. Workers are joined in creation order.
+  virtual AstListener* clone() const { return nullptr; }
+  virtual void join(AstListener* worker) {}
+
   // clang-format off
 <PUBLIC_ENTER_LEAVE_DECLARATIONS>
   // clang-format on
@@ -130,15 +134,35 @@ class AstListener {
                        astnode_vector_t& siblings) const;
 
  private:
-  // clang-format off
-<PRIVATE_LISTEN_DECLARATIONS>
-  // clang-format on
+  // Traversal state of a node whose children are being listened to, the
+  // ones left are m_children[m_next, m_end).
+  struct Frame final {
+    AstNode m_node;
+    uint32_t m_begin = 0;
+    uint32_t m_next = 0;
+    uint32_t m_end = 0;
+    bool m_entered = false;  // leave callback due once the children are done
+  };
+
+  // Return false for node types without enter/leave callbacks, those are
+  // not traversed.
+  bool enterNode_(const AstNode& node);
+  void leaveNode_(const AstNode& node);
+  void visit_(const AstNode& node);
+  void pushChildren_(const AstNode& node, NodeId first, NodeId skip,
+                     bool ordered, bool entered);
+  void walk_(size_t depth);
 
  protected:
-  astnode_set_t m_visited;
+  std::vector<bool> m_visited;  // Indexed by node
   astnode_stack_t m_callstack;
 
  private:
+  // Explicit traversal stack, both are reused from node to node and file to
+  // file so a walk doesn't allocate once they reached their high water mark.
+  std::vector<Frame> m_frames;
+  std::vector<NodeId> m_children;
+
   const VObject* m_objects = nullptr;
   uint32_t m_count = 0;
   const SymbolTable* m_symbolTable = nullptr;
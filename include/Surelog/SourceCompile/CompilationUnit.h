@@ -29,6 +29,11 @@
 #include <Surelog/Common/NodeId.h>
 #include <Surelog/Design/TimeInfo.h>
 
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace SURELOG {
 
 class MacroInfo;
@@ -47,9 +52,29 @@ class CompilationUnit {
   void registerMacroInfo(const std::string& macroName, MacroInfo* macro);
   MacroInfo* getMacroInfo(const std::string& macroName);
 
+  // Macros defined in this unit, the base layer is not included.
   const MacroStorageRef& getMacros() const { return m_macros; }
   void deleteMacro(const std::string& macroName);
-  void deleteAllMacros() { m_macros.clear(); }
+  void deleteAllMacros();
+
+  // Read-only macro layer shared by several compilation units (builtin
+  // macros). Lookups fall back to it when the unit does not define the macro
+  // itself, `undef and `undefineall only hide its entries for this unit.
+  void setBaseMacros(const MacroStorageRef* baseMacros) {
+    m_baseMacros = baseMacros;
+  }
+  const MacroStorageRef* getBaseMacros() const { return m_baseMacros; }
+
+  // Speculative preprocessing (see Compiler::preprocessSpeculatively_): the
+  // unit stands for the compilation unit as it would be at the start of a
+  // file if no earlier file had changed it. It logs the macro lookups whose
+  // result depends on that assumption and every change it goes through.
+  void setSpeculative() { m_speculative = true; }
+  bool isSpeculative() const { return m_speculative; }
+  // True if the lookups give the same results against the actual unit.
+  bool isSpeculationValid(const CompilationUnit& actual) const;
+  // Applies the logged changes, in order, to the actual unit.
+  void replaySpeculation(CompilationUnit* actual) const;
 
   /* Following methods deal with `timescale */
   void setCurrentTimeInfo(PathId fileId);
@@ -76,11 +101,34 @@ class CompilationUnit {
   bool m_inDesignElement;
 
   MacroStorageRef m_macros;
+  const MacroStorageRef* m_baseMacros = nullptr;
+  std::set<std::string, std::less<>> m_hiddenBaseMacros;
+  bool m_hideAllBaseMacros = false;
 
   std::vector<TimeInfo> m_timeInfo;
   std::vector<NetTypeInfo> m_defaultNetTypes;
   TimeInfo m_noTimeInfo;
 
+  MacroInfo* findMacro_(std::string_view macroName) const;
+
+  struct Change final {
+    enum class Kind {
+      DefineMacro,
+      UndefineMacro,
+      UndefineAllMacros,
+      SetCurrentTimeInfo,
+      RecordTimeInfo
+    };
+    Kind m_kind = Kind::DefineMacro;
+    std::string m_macroName;
+    MacroInfo* m_macro = nullptr;
+    TimeInfo m_timeInfo;
+  };
+  bool m_speculative = false;
+  std::vector<Change> m_changes;
+  std::set<std::string, std::less<>> m_changedMacros;
+  std::set<std::string, std::less<>> m_speculativeLookups;
+
   /* Design Info helper data */
   NodeId m_uniqueIdGenerator;
   NodeId m_uniqueNodeIdGenerator;
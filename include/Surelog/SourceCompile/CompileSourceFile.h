@@ -28,8 +28,12 @@
 #include <Surelog/Common/SymbolId.h>
 #include <Surelog/SourceCompile/PreprocessFile.h>
 
+#include <cstdint>
+#include <list>
 #include <map>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #ifdef SURELOG_WITH_PYTHON
@@ -77,17 +81,29 @@ class CompileSourceFile final {
   void registerPP(PreprocessFile* pp) { m_ppIncludeVec.push_back(pp); }
   bool initParser();
 
-  const std::map<SymbolId, PreprocessFile::AntlrParserHandler*,
-                 SymbolIdLessThanComparer>&
-  getPpAntlrHandlerMap() const {
-    return m_antlrPpMacroMap;
+  struct MacroHandlerCacheStats final {
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+  };
+
+  // Macro body handlers are keyed by PreprocessFile::getMacroSignature(),
+  // the body text guards against hash collisions. The cache keeps at most
+  // kMaxMacroHandlers entries, least recently used ones are evicted first.
+  void registerAntlrPpHandlerForMacro(uint64_t signature,
+                                      std::string_view body,
+                                      PreprocessFile::AntlrParserHandler* pp);
+  PreprocessFile::AntlrParserHandler* getAntlrPpHandlerForMacro(
+      uint64_t signature, std::string_view body);
+  const MacroHandlerCacheStats& getMacroHandlerCacheStats() const {
+    return m_macroHandlerStats;
   }
-  void registerAntlrPpHandlerForId(SymbolId id,
-                                   PreprocessFile::AntlrParserHandler* pp);
   void registerAntlrPpHandlerForId(PathId id,
                                    PreprocessFile::AntlrParserHandler* pp);
-  PreprocessFile::AntlrParserHandler* getAntlrPpHandlerForId(SymbolId);
   PreprocessFile::AntlrParserHandler* getAntlrPpHandlerForId(PathId);
+  // Deletes the preprocessor token streams and trees, only valid once no
+  // more preprocessing can happen.
+  void releaseAntlrPpHandlers();
 
 #ifdef SURELOG_WITH_PYTHON
   void setPythonInterp(PyThreadState* interpState);
@@ -97,6 +113,12 @@ class CompileSourceFile final {
 
   void setSymbolTable(SymbolTable* symbols);
   void setErrorContainer(ErrorContainer* errors) { m_errors = errors; }
+  void setCompilationUnit(CompilationUnit* compilationUnit);
+  CompilationUnit* getCompilationUnit() const { return m_compilationUnit; }
+
+  // Saves the preprocessor cache, done by preprocess_() unless the
+  // compilation unit is speculative.
+  void savePreprocessorCache();
 
   // Get size of job approximated by size of file to process.
   uint64_t getJobSize(Action action) const;
@@ -118,6 +140,8 @@ class CompileSourceFile final {
 
   bool pythonAPI_();
 
+  void evictMacroHandlers_();
+
   PathId m_fileId;
   CommandLineParser* m_commandLineParser = nullptr;
   ErrorContainer* m_errors = nullptr;
@@ -129,9 +153,17 @@ class CompileSourceFile final {
   CompilationUnit* m_compilationUnit = nullptr;
   Action m_action = Action::Preprocess;
   PathId m_ppResultFileId;
-  std::map<SymbolId, PreprocessFile::AntlrParserHandler*,
-           SymbolIdLessThanComparer>
+  struct MacroHandlerEntry final {
+    std::string m_body;
+    PreprocessFile::AntlrParserHandler* m_handler = nullptr;
+    std::list<uint64_t>::iterator m_lruPos;
+  };
+  static constexpr size_t kMaxMacroHandlers = 1024;
+  std::unordered_map<uint64_t, MacroHandlerEntry>
       m_antlrPpMacroMap;  // Preprocessor Antlr Handlers (One per macro)
+  std::list<uint64_t> m_macroHandlerLru;  // Most recently used first
+  std::vector<PreprocessFile::AntlrParserHandler*> m_retiredMacroHandlers;
+  MacroHandlerCacheStats m_macroHandlerStats;
   std::map<PathId, PreprocessFile::AntlrParserHandler*, PathIdLessThanComparer>
       m_antlrPpFileMap;  // Preprocessor Antlr Handlers (One per included file)
 #ifdef SURELOG_WITH_PYTHON
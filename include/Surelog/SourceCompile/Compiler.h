@@ -38,9 +38,13 @@ limitations under the License.
 #include <tbb/task_scheduler_init.h>
 #endif
 
+#include <condition_variable>
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace SURELOG {
@@ -96,11 +100,30 @@ class Compiler {
   ErrorContainer::Stats getErrorStats() const;
   bool isLibraryFile(PathId id) const;
   const PPFileMap& getPPFileMap() { return m_ppFileMap; }
+
+  // Bounded memory parsing (-boundedmem): a file holds a slot from the
+  // start of its tokenization until its ANTLR data is released.
+  void acquireParseSlot();
+  void releaseParseSlot();
 #ifdef USETBB
   tbb::task_group& getTaskGroup() { return m_taskGroup; }
 #endif
 
  private:
+  // -profile: resources in use at the end of a compilation stage.
+  struct StageProfile {
+    std::string m_name;
+    double m_seconds = 0;
+    uint64_t m_peakRss = 0;
+    uint64_t m_rss = 0;
+    uint64_t m_heapInUse = 0;
+    int64_t m_heapDelta = 0;  // since the end of the previous stage
+    uint64_t m_vobjectCount = 0;
+    uint64_t m_symbolCount = 0;
+    uint64_t m_moduleInstanceCount = 0;
+    uint64_t m_uhdmObjectCount = 0;
+  };
+
   Compiler(const Compiler& orig) = delete;
   bool parseLibrariesDef_();
 
@@ -114,7 +137,22 @@ class Compiler {
                        std::vector<CompileSourceFile*>& container);
   bool compileOneFile_(CompileSourceFile* compileSource,
                        CompileSourceFile::Action action);
+  // Multithreaded preprocessing of the files sharing the compilation unit,
+  // each file is preprocessed as if the files before it had not changed the
+  // unit, then validated and replayed (or preprocessed again) in file order.
+  bool preprocessSpeculatively_();
   bool cleanup_();
+  // -boundedmem: frees the preprocessor ANTLR data ahead of the UHDM
+  // creation and save, the memory peak of the run.
+  void releaseAntlrPpHandlers_();
+  bool writeParserDecisionProfile_();
+  // Restores (or saves) the preprocessor and parser prediction DFAs from the
+  // -dfacache directory, returns the profile message.
+  std::string cacheParserDFA_(bool save);
+  // Records the stage in m_stageProfiles, returns the profile message.
+  std::string profileStage_(std::string_view name, double seconds);
+  // Writes m_stageProfiles as JSON next to the log file.
+  bool writeProfileJson_(double totalSeconds);
 
   CommandLineParser* const m_commandLineParser;
   ErrorContainer* const m_errors;
@@ -128,6 +166,8 @@ class Compiler {
   std::vector<CompileSourceFile*> m_compilersParentFiles;
   std::vector<CompilationUnit*> m_compilationUnits;
   std::vector<SymbolTable*> m_symbolTables;
+  // Preprocessor symbols of the speculative runs, needed until the end.
+  std::vector<SymbolTable*> m_speculativeSymbolTables;
   std::vector<ErrorContainer*> m_errorContainers;
   LibrarySet* const m_librarySet;
   ConfigSet* const m_configSet;
@@ -137,6 +177,10 @@ class Compiler {
   std::string m_text;        // unit tests
   CompileDesign* m_compileDesign;
   PPFileMap m_ppFileMap;
+  std::mutex m_parseSlotMutex;
+  std::condition_variable m_parseSlotCondition;
+  unsigned int m_parseSlotsInUse = 0;
+  std::vector<StageProfile> m_stageProfiles;
 #ifdef USETBB
   tbb::task_group m_taskGroup;
 #endif
@@ -0,0 +1,72 @@
+/*
+ Copyright 2019 Alain Dargelas
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef SURELOG_MACROEXPANDER_H
+#define SURELOG_MACROEXPANDER_H
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SURELOG {
+
+class PreprocessFile;
+
+// Expands the macro instances found in an already argument-substituted macro
+// body without going through the ANTLR preprocessor lexer/parser/listener.
+// The body is tokenized first; if it contains anything the preprocessor
+// grammar gives a special meaning to (directives, comments, escapes,
+// design element keywords, numbers whose spelling the listener rewrites,
+// macro calls in macro arguments, ...) tokenize() returns false and the
+// caller falls back to PreprocessFile::preprocess().
+// Otherwise expand() produces, in the macro body PreprocessFile, the same
+// text and include info records as SV3_1aPpTreeShapeListener would.
+class MacroExpander final {
+ public:
+  explicit MacroExpander(PreprocessFile* pp) : m_pp(pp) {}
+
+  bool tokenize(std::string_view body);
+  void expand();
+
+ private:
+  MacroExpander(const MacroExpander& orig) = delete;
+
+  struct Segment final {
+    enum Kind { Text, MacroNoArgs, MacroWithArgs };
+    Kind m_kind = Text;
+    std::string m_text;  // Text or macro name (without the `)
+    std::vector<std::string> m_arguments;
+    int m_nbCRinArgs = 0;
+    // Same conventions as ParseUtils::getLineColumn/getEndLineColumn
+    int m_line = 0;
+    int m_column = 0;
+    int m_endColumn = 0;
+  };
+
+  void appendText_(std::string_view text);
+  bool tokenizeNumber_(std::string_view body, size_t& pos);
+  bool tokenizeArguments_(std::string_view body, size_t& pos,
+                          Segment& segment);
+  void expandMacro_(const Segment& segment);
+
+  PreprocessFile* const m_pp;
+  std::vector<Segment> m_segments;
+};
+
+}  // namespace SURELOG
+
+#endif /* SURELOG_MACROEXPANDER_H */
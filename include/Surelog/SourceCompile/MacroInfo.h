@@ -27,6 +27,7 @@
 
 #include <Surelog/Common/PathId.h>
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -45,6 +46,22 @@ class MacroInfo {
     WITH_ARGS,
   };
 
+  // Formal argument with the blanks removed, split from its default value.
+  struct Formal final {
+    std::string m_name;
+    std::string m_default;
+    bool m_hasDefault = false;
+  };
+
+  // Formal arguments as recordMacro() takes them, "name" or "name=default".
+  std::vector<std::string> getArguments() const;
+  std::vector<std::string> getTokens() const;
+
+  // Returns the body with each formal argument replaced by its value.
+  // actual[i] is false when values[i] is the default value or left empty.
+  std::string substitute(const std::vector<std::string_view>& values,
+                         const std::vector<bool>& actual) const;
+
   const std::string m_name;
   const int m_type;
   const PathId m_fileId;
@@ -52,8 +69,35 @@ class MacroInfo {
   const unsigned short int m_startColumn;
   const unsigned int m_endLine;
   const unsigned short int m_endColumn;
-  const std::vector<std::string> m_arguments;
-  const std::vector<std::string> m_tokens;
+  const std::vector<Formal> m_formals;
+  // Body tokens laid end to end, the escapes that do not depend on the
+  // actual arguments (`\", `\`\" and ``_``) are expanded once here.
+  const std::string m_body;
+  // End offset of each token in m_body
+  const std::vector<uint32_t> m_tokenEnds;
+  // The body or a default value spans several lines
+  const bool m_multiLine;
+
+ private:
+  // Span of m_body or, if m_formal is not negative, the value of that
+  // formal argument.
+  struct Piece final {
+    uint32_t m_offset = 0;
+    uint32_t m_length = 0;
+    int16_t m_formal = -1;
+    // Between double quotes, the line feeds of the value are removed
+    bool m_removeLF = false;
+  };
+
+  bool resolveFormals_();
+  bool isInert_(const std::vector<std::string_view>& values) const;
+  std::string substituteTokens_(const std::vector<std::string_view>& values,
+                                const std::vector<bool>& actual) const;
+
+  // Body with the formal arguments resolved once, valid if m_resolved.
+  // substitute() falls back to replacing tokens otherwise.
+  std::vector<Piece> m_pieces;
+  bool m_resolved = false;
 };
 
 };  // namespace SURELOG
@@ -28,6 +28,8 @@
 #include <Surelog/ErrorReporting/Error.h>
 
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace SURELOG {
 
@@ -39,6 +41,7 @@ class ErrorContainer;
 class FileContent;
 class Library;
 class SV3_1aPythonListener;
+class SllBailErrorStrategy;
 class SV3_1aTreeShapeListener;
 class SymbolTable;
 
@@ -90,6 +93,26 @@ class ParseFile final {
     unsigned int m_pretendLine;
   };
 
+  // Machine readable record of a parser decision that needed attention:
+  // an SLL bail out, the LL re-parse of the description it happened in, or
+  // profiled LL fallbacks/ambiguities of a decision.
+  class DecisionProfileInfo {
+   public:
+    DecisionProfileInfo(std::string_view event, int decision,
+                        std::string_view rule, unsigned int line,
+                        uint64_t count)
+        : m_event(event),
+          m_decision(decision),
+          m_rule(rule),
+          m_line(line),
+          m_count(count) {}
+    std::string m_event;
+    int m_decision;
+    std::string m_rule;
+    unsigned int m_line;
+    uint64_t m_count;
+  };
+
   AntlrParserHandler* getAntlrParserHandler() const {
     return m_antlrParserHandler;
   }
@@ -107,6 +130,9 @@ class ParseFile final {
   void setFileContent(FileContent* content) { m_fileContent = content; }
   void setDebugAstModel() { debug_AstModel = true; }
   std::string getProfileInfo() const;
+  const std::vector<DecisionProfileInfo>& getDecisionProfile() const {
+    return m_decisionProfile;
+  }
   void profileParser();
 
  private:
@@ -124,6 +150,8 @@ class ParseFile final {
   bool debug_AstModel;
 
   bool parseOneFile_(PathId fileId, unsigned int lineOffset);
+  bool reparseDescriptionsLL_(SllBailErrorStrategy* strategy);
+  void releaseParserHandler_();
   void buildLineInfoCache_();
   // For file chunk:
   std::vector<ParseFile*> m_children;
@@ -132,6 +160,7 @@ class ParseFile final {
   SymbolTable* const m_symbolTable;
   ErrorContainer* const m_errors;
   std::string m_profileInfo;
+  std::vector<DecisionProfileInfo> m_decisionProfile;
   std::string m_sourceText;  // For Unit tests
   std::vector<unsigned int> lineInfoCache;
   std::vector<PathId> fileInfoCache;
@@ -32,6 +32,7 @@ namespace SURELOG {
 
 class Compiler;
 class FileContent;
+class ParseFile;
 
 class ParserHarness {
  public:
@@ -45,6 +46,9 @@ class ParserHarness {
                      PathId fileId);
   ~ParserHarness();
 
+  // Parser of the last unit test parse()
+  const ParseFile* parseFile() const;
+
  private:
   struct Holder;
   Holder* m_h = nullptr;
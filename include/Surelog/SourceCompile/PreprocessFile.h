@@ -31,6 +31,7 @@
 #include <Surelog/SourceCompile/IncludeFileInfo.h>
 #include <Surelog/SourceCompile/LoopCheck.h>
 
+#include <cstdint>
 #include <set>
 #include <vector>
 
@@ -90,6 +91,8 @@ class PreprocessFile final {
   /* Main function */
   bool preprocess();
   std::string getPreProcessedFileContent();
+  // Raw result of the last preprocess() call, no copy
+  std::string_view getPreProcessedResult() const { return m_result; }
 
   /* Macro manipulations */
   void recordMacro(const std::string& name, unsigned int startLine,
@@ -114,7 +117,8 @@ class PreprocessFile final {
   bool isMacroBody() const { return !m_macroBody.empty(); }
   const std::string& getMacroBody() const { return m_macroBody; }
   MacroInfo* getMacroInfo() { return m_macroInfo; }
-  SymbolId getMacroSignature();
+  // Hash of the macro identity and of its expanded body
+  uint64_t getMacroSignature() const;
   const MacroStorage& getMacros() const { return m_macros; }
   MacroInfo* getMacro(const std::string& name);
 
@@ -124,6 +128,9 @@ class PreprocessFile final {
     return m_compileSourceFile;
   }
   CompilationUnit* getCompilationUnit() const { return m_compilationUnit; }
+  void setCompilationUnit(CompilationUnit* compilationUnit) {
+    m_compilationUnit = compilationUnit;
+  }
   Library* getLibrary() const { return m_library; }
   antlr4::CommonTokenStream* getTokenStream() const {
     return m_antlrParserHandler ? m_antlrParserHandler->m_pptokens : nullptr;
@@ -271,6 +278,9 @@ class PreprocessFile final {
     SV3_1aPpParser* m_ppparser = nullptr;
     antlr4::tree::ParseTree* m_pptree = nullptr;
     DescriptiveErrorListener* m_errorListener = nullptr;
+    // Number of listeners currently walking m_pptree, the handler cannot be
+    // evicted from the macro handler cache while it is non zero.
+    unsigned int m_activeWalks = 0;
   };
   SV3_1aPpTreeShapeListener* m_listener = nullptr;
 
@@ -335,6 +345,10 @@ class PreprocessFile final {
                             const std::vector<std::string>& arguments,
                             const std::vector<std::string>& tokens);
   void forgetPreprocessor_(PreprocessFile*, PreprocessFile* pp);
+
+  // Expands a macro body without the ANTLR preprocessor when it only holds
+  // text and macro instances, returns false if preprocess() is needed.
+  bool expandMacroBody_();
   AntlrParserHandler* m_antlrParserHandler = nullptr;
 
   /* Only used when preprocessing a macro content */
@@ -27,8 +27,11 @@
 
 #include <Surelog/ErrorReporting/ErrorContainer.h>
 #include <Surelog/SourceCompile/CompilationUnit.h>
+#include <Surelog/SourceCompile/IncludeFileInfo.h>
 #include <Surelog/SourceCompile/SymbolTable.h>
 
+#include <vector>
+
 namespace SURELOG {
 
 class PreprocessHarness {
@@ -38,10 +41,19 @@ class PreprocessHarness {
                          CompilationUnit* compUnit = nullptr);
 
   const ErrorContainer& collected_errors() const { return m_errors; }
+  // Include file infos of the last preprocessed content
+  const std::vector<IncludeFileInfo>& collected_include_file_infos() const {
+    return m_includeFileInfos;
+  }
+
+  // True expands plain macro bodies directly (-macroexp)
+  void setMacroExpander(bool val) { m_macroExpander = val; }
 
  private:
   SymbolTable m_symbols;
   ErrorContainer m_errors;
+  std::vector<IncludeFileInfo> m_includeFileInfos;
+  bool m_macroExpander = false;
 };
 
 };  // namespace SURELOG
@@ -25,8 +25,11 @@
 #define SURELOG_CLASSOBJECT_H
 #pragma once
 
+#include <Surelog/Common/Containers.h>
+
 #include <map>
 #include <string>
+#include <string_view>
 
 namespace SURELOG {
 
@@ -36,14 +39,15 @@ class Value;
 
 class ClassObject final {
  public:
-  typedef std::map<std::string, std::pair<Property*, Value*>> PropertyValueMap;
+  typedef std::map<std::string, std::pair<Property*, Value*>, StringViewCompare>
+      PropertyValueMap;
 
   ClassObject(ClassDefinition* class_def) : m_class(class_def) {}
   ClassDefinition* getClass() { return m_class; }
 
   const PropertyValueMap& getProperties() const { return m_properties; }
-  bool setValue(const std::string& property, Value* value);
-  Value* getValue(const std::string& property) const;
+  bool setValue(std::string_view property, Value* value);
+  Value* getValue(std::string_view property) const;
 
  private:
   ClassObject(const ClassObject& orig) = delete;
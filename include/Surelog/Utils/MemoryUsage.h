@@ -0,0 +1,45 @@
+/*
+ Copyright 2019 Alain Dargelas
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef SURELOG_MEMORYUSAGE_H
+#define SURELOG_MEMORYUSAGE_H
+#pragma once
+
+#include <cstdint>
+
+namespace SURELOG {
+
+// Process memory figures in bytes, 0 when the platform does not provide them.
+class MemoryUsage final {
+ public:
+  // High water mark of the resident set size since the process started.
+  static uint64_t getPeakRss();
+
+  // Current resident set size.
+  static uint64_t getCurrentRss();
+
+  // Bytes currently handed out by the heap allocator.
+  static uint64_t getHeapInUse();
+
+ private:
+  MemoryUsage() = delete;
+  MemoryUsage(const MemoryUsage& orig) = delete;
+  ~MemoryUsage() = delete;
+};
+
+}  // namespace SURELOG
+
+#endif /* SURELOG_MEMORYUSAGE_H */
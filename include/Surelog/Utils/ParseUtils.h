@@ -27,6 +27,9 @@
 
 #include <ParserRuleContext.h>
 
+#include <string>
+#include <vector>
+
 namespace SURELOG {
 
 class ParseUtils final {
@@ -47,6 +50,8 @@ class ParseUtils final {
   static std::vector<ParseTree*> getTopTokenList(ParseTree* tree);
   static void tokenizeAtComma(std::vector<std::string>& actualArgs,
                               const std::vector<ParseTree*>& tokens);
+  static void tokenizeAtComma(std::vector<std::string>& actualArgs,
+                              const std::vector<std::string>& tokens);
 
   static std::vector<antlr4::Token*> getFlatTokenList(ParseTree* tree);
 
@@ -96,6 +96,9 @@ class StringUtils final {
                                    std::string_view pattern,
                                    std::string_view news);
 
+  // Remove line feed unless it is escaped with backslash.
+  static std::string removeLF(std::string_view st);
+
   // Remove whitespace at the beginning of the string.
   [[nodiscard]] static std::string_view ltrim(std::string_view str);
 
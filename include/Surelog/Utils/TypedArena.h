@@ -0,0 +1,88 @@
+/*
+ Copyright 2019 Alain Dargelas
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef SURELOG_TYPEDARENA_H
+#define SURELOG_TYPEDARENA_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace SURELOG {
+
+// Allocates objects of exactly type T out of fixed size blocks. Objects are
+// never freed individually, they are all destroyed (in reverse allocation
+// order) when the arena is cleared or destroyed. make() is thread safe.
+// T only needs to be complete where the member functions are used.
+template <typename T>
+class TypedArena final {
+ public:
+  static constexpr size_t kObjectsPerBlock = 512;
+
+  TypedArena() = default;
+  TypedArena(const TypedArena&) = delete;
+  TypedArena& operator=(const TypedArena&) = delete;
+  ~TypedArena() { clear(); }
+
+  template <typename... Args>
+  T* make(Args&&... args) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_blocks.empty() || (m_usedInLastBlock == kObjectsPerBlock)) {
+      m_blocks.emplace_back(::operator new(sizeof(T) * kObjectsPerBlock));
+      m_usedInLastBlock = 0;
+    }
+    void* slot = static_cast<char*>(m_blocks.back()) +
+                 sizeof(T) * m_usedInLastBlock;
+    T* object = new (slot) T(std::forward<Args>(args)...);
+    ++m_usedInLastBlock;
+    ++m_objectCount;
+    return object;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (size_t i = m_blocks.size(); i-- > 0;) {
+      T* const objects = static_cast<T*>(m_blocks[i]);
+      size_t count =
+          (i + 1 == m_blocks.size()) ? m_usedInLastBlock : kObjectsPerBlock;
+      while (count-- > 0) objects[count].~T();
+      ::operator delete(m_blocks[i]);
+    }
+    m_blocks.clear();
+    m_usedInLastBlock = 0;
+    m_objectCount = 0;
+  }
+
+  uint64_t getObjectCount() const { return m_objectCount; }
+  uint64_t getBlockCount() const { return m_blocks.size(); }
+  uint64_t getReservedBytes() const {
+    return m_blocks.size() * kObjectsPerBlock * sizeof(T);
+  }
+
+ private:
+  std::mutex m_mutex;
+  std::vector<void*> m_blocks;
+  size_t m_usedInLastBlock = 0;
+  uint64_t m_objectCount = 0;
+};
+
+}  // namespace SURELOG
+
+#endif /* SURELOG_TYPEDARENA_H */
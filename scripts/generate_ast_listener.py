@@ -337,18 +337,15 @@ def _generate_header(input_filepath: str, output_filepath: str):
   global _type_names
 
   public_enter_leave_declarations = []
-  private_listen_declarations = []
   for type_name in _type_names:
     public_enter_leave_declarations.extend([
      f'  virtual void enter{type_name}(const SURELOG::AstNode& node) {{}}',
      f'  virtual void leave{type_name}(const SURELOG::AstNode& node) {{}}',
       ''
     ])
-    private_listen_declarations.append(f'  void listen{type_name}(const AstNode& node);')
 
   content = open(input_filepath, 'rt').read()
   content = content.replace('<PUBLIC_ENTER_LEAVE_DECLARATIONS>', '\n'.join(public_enter_leave_declarations).rstrip())
-  content = content.replace('<PRIVATE_LISTEN_DECLARATIONS>', '\n'.join(private_listen_declarations).rstrip())
   _write_output(output_filepath, content)
 
 
@@ -371,22 +368,12 @@ def _generate_tracer(input_filepath: str, output_filepath: str):
 def _generate_source(input_filepath: str, output_filepath: str):
   global _type_names
 
-  private_listen_implementations = []
-  for type_name in _type_names:
-    private_listen_implementations.extend([
-     f'void AstListener::listen{type_name}(const AstNode& node) {{',
-     f'  enter{type_name}(node);',
-      '  listenChildren(node, true);',
-     f'  leave{type_name}(node);',
-      '}',
-      ''
-    ])
-
-  listen_case_statements = [f'    case VObjectType::sl{type_name}: listen{type_name}(node); break;' for type_name in _type_names]
+  enter_case_statements = [f'    case VObjectType::sl{type_name}: enter{type_name}(node); return true;' for type_name in _type_names]
+  leave_case_statements = [f'    case VObjectType::sl{type_name}: leave{type_name}(node); break;' for type_name in _type_names]
 
   content = open(input_filepath, 'rt').read()
-  content = content.replace('<PRIVATE_LISTEN_IMPLEMENTATIONS>', '\n'.join(private_listen_implementations).rstrip())
-  content = content.replace('<LISTEN_CASE_STATEMENTS>', '\n'.join(listen_case_statements).rstrip())
+  content = content.replace('<ENTER_CASE_STATEMENTS>', '\n'.join(enter_case_statements).rstrip())
+  content = content.replace('<LEAVE_CASE_STATEMENTS>', '\n'.join(leave_case_statements).rstrip())
   _write_output(output_filepath, content)
 
 
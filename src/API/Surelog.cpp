@@ -25,6 +25,15 @@
 #include <Surelog/SourceCompile/Compiler.h>
 #include <Surelog/SourceCompile/ParseFile.h>
 
+// UHDM
+#include <uhdm/module.h>
+#include <uhdm/vpi_uhdm.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
 namespace SURELOG {
 
 scompiler* start_compiler(CommandLineParser* clp) {
@@ -58,15 +67,66 @@ vpiHandle get_uhdm_design(scompiler* compiler) {
   return design_handle;
 }
 
-void walk_ast(scompiler* compiler, AstListener* listener) {
+vpiHandle get_uhdm_elaborated_top(scompiler* compiler,
+                                  std::string_view topName) {
+  Compiler* the_compiler = (Compiler*)compiler;
+  if (!the_compiler || !the_compiler->getCompileDesign()) return 0;
+  UHDM::module* top =
+      the_compiler->getCompileDesign()->elaborateUhdmTop(topName);
+  if (top == nullptr) return 0;
+  return reinterpret_cast<vpiHandle>(
+      new uhdm_handle(UHDM::uhdmmodule, top));
+}
+
+static void walk_file(const CompileSourceFile* csf, AstListener* listener) {
+  const FileContent* const fC = csf->getParser()->getFileContent();
+  const std::vector<VObject>& objects = fC->getVObjects();
+  const SymbolTable* const symbolTable = fC->getSymbolTable();
+  listener->listen(fC->getFileId(), objects.data(), objects.size(),
+                   symbolTable);
+}
+
+void walk_ast(scompiler* compiler, AstListener* listener, uint32_t nbThreads) {
   if (!compiler || !listener) return;
   Compiler* the_compiler = (Compiler*)compiler;
-  for (const CompileSourceFile* csf : the_compiler->getCompileSourceFiles()) {
-    const FileContent* const fC = csf->getParser()->getFileContent();
-    const std::vector<VObject>& objects = fC->getVObjects();
-    const SymbolTable* const symbolTable = fC->getSymbolTable();
-    listener->listen(fC->getFileId(), objects.data(), objects.size(),
-                     symbolTable);
+  const std::vector<CompileSourceFile*>& files =
+      the_compiler->getCompileSourceFiles();
+
+  std::vector<AstListener*> workers;
+  const size_t maxWorkers = std::min<size_t>(nbThreads, files.size());
+  if (maxWorkers > 1) {
+    while (workers.size() < maxWorkers) {
+      AstListener* const worker = listener->clone();
+      if (worker == nullptr) break;
+      workers.emplace_back(worker);
+    }
+  }
+
+  if (workers.empty()) {
+    for (const CompileSourceFile* csf : files) {
+      walk_file(csf, listener);
+    }
+    return;
+  }
+
+  // Files are handed out one at a time, their sizes vary a lot
+  std::atomic<size_t> nextFile(0);
+  std::vector<std::thread> threads;
+  threads.reserve(workers.size());
+  for (AstListener* worker : workers) {
+    threads.emplace_back([&files, &nextFile, worker]() {
+      for (size_t index = nextFile++; index < files.size();
+           index = nextFile++) {
+        walk_file(files[index], worker);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (AstListener* worker : workers) {
+    listener->join(worker);
+    delete worker;
   }
 }
 
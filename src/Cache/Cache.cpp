@@ -26,6 +26,7 @@
 #include <Surelog/Common/FileSystem.h>
 #include <Surelog/Design/FileContent.h>
 #include <Surelog/ErrorReporting/ErrorContainer.h>
+#include <Surelog/Package/Precompiled.h>
 #include <Surelog/SourceCompile/SymbolTable.h>
 #include <flatbuffers/util.h>
 #include <sys/stat.h>
@@ -48,6 +49,20 @@ bool Cache::openFlatBuffers(PathId cacheFileId,
   return fileSystem->loadContent(cacheFileId, content);
 }
 
+bool Cache::openFlatBuffers(
+    PathId cacheFileId, bool isPrecompiled,
+    std::shared_ptr<const std::vector<char>>& content) const {
+  if (isPrecompiled) {
+    content = Precompiled::getSingleton()->loadImage(cacheFileId);
+    return content != nullptr;
+  }
+  std::shared_ptr<std::vector<char>> buffer =
+      std::make_shared<std::vector<char>>();
+  if (!openFlatBuffers(cacheFileId, *buffer)) return false;
+  content = std::move(buffer);
+  return true;
+}
+
 bool Cache::checkIfCacheIsValid(const SURELOG::CACHE::Header* header,
                                 std::string_view schemaVersion,
                                 PathId cacheFileId, PathId sourceFileId) const {
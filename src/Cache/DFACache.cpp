@@ -0,0 +1,388 @@
+/*
+ Copyright 2019 Alain Dargelas
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include <Surelog/Cache/DFACache.h>
+#include <Surelog/Cache/dfa_generated.h>
+#include <Surelog/CommandLine/CommandLineParser.h>
+#include <Surelog/Common/FileSystem.h>
+#include <Surelog/SourceCompile/SymbolTable.h>
+#include <Surelog/Utils/StringUtils.h>
+#include <antlr4-runtime.h>
+
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <unordered_map>
+
+namespace SURELOG {
+static constexpr char FlbSchemaVersion[] = "1.0";
+
+// Shared pointer type the runtime uses for prediction contexts.
+using PredictionContextRef =
+    std::remove_const_t<decltype(antlr4::atn::ATNConfig::context)>;
+
+// Hash of the ATN shape, rule names and vocabulary: a DFA is only meaningful
+// for the exact grammar that produced it.
+static uint64_t grammarFingerprint(antlr4::Parser* parser) {
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](uint64_t value) {
+    hash ^= value;
+    hash *= 1099511628211ULL;
+  };
+  const antlr4::atn::ATN& atn = parser->getATN();
+  mix(atn.maxTokenType);
+  mix(atn.states.size());
+  for (const antlr4::atn::ATNState* state : atn.states) {
+    if (state == nullptr) {
+      mix(0);
+      continue;
+    }
+    mix(static_cast<uint64_t>(state->getStateType()));
+    mix(state->ruleIndex);
+    mix(state->transitions.size());
+    for (const auto& transition : state->transitions) {
+      mix(transition->target->stateNumber);
+    }
+  }
+  mix(atn.decisionToState.size());
+  std::hash<std::string> hasher;
+  for (const std::string& rule : parser->getRuleNames()) mix(hasher(rule));
+  const antlr4::dfa::Vocabulary& vocabulary = parser->getVocabulary();
+  for (size_t type = 0; type <= vocabulary.getMaxTokenType(); ++type) {
+    mix(hasher(vocabulary.getSymbolicName(type)));
+  }
+  return hash;
+}
+
+namespace {
+// Writes a prediction context graph bottom-up so that parents are always
+// restored before their children.
+class ContextWriter {
+ public:
+  using ContextOffset = flatbuffers::Offset<DFACACHE::PredictionContext>;
+
+  explicit ContextWriter(flatbuffers::FlatBufferBuilder& builder)
+      : m_builder(builder) {}
+
+  // Depth first with an explicit stack: a context chain has one level per
+  // pending rule invocation, deep enough to overflow the call stack.
+  int32_t write(const PredictionContextRef& context) {
+    if (context == nullptr) return -1;
+    if (m_ids.find(context.get()) == m_ids.end()) {
+      std::vector<Pending> stack(1, Pending{context, 0});
+      while (!stack.empty()) {
+        Pending& pending = stack.back();
+        const antlr4::atn::PredictionContext* current = pending.m_context.get();
+        if (!current->isEmpty() && (pending.m_nextParent < current->size())) {
+          PredictionContextRef parent =
+              current->getParent(pending.m_nextParent++);
+          if ((parent != nullptr) &&
+              (m_ids.find(parent.get()) == m_ids.end())) {
+            stack.push_back(Pending{std::move(parent), 0});
+          }
+          continue;
+        }
+        if (m_ids.find(current) == m_ids.end()) writeOne_(current);
+        stack.pop_back();
+      }
+    }
+    return m_ids.find(context.get())->second;
+  }
+
+  const std::vector<ContextOffset>& getContexts() const { return m_contexts; }
+
+ private:
+  struct Pending {
+    PredictionContextRef m_context;
+    size_t m_nextParent;
+  };
+
+  // All the parents are written already
+  void writeOne_(const antlr4::atn::PredictionContext* context) {
+    const bool empty = context->isEmpty();
+    std::vector<int32_t> parents;
+    std::vector<uint32_t> returnStates;
+    if (!empty) {
+      for (size_t i = 0; i < context->size(); ++i) {
+        const PredictionContextRef parent = context->getParent(i);
+        parents.emplace_back(
+            (parent == nullptr) ? -1 : m_ids.find(parent.get())->second);
+        returnStates.emplace_back(
+            static_cast<uint32_t>(context->getReturnState(i)));
+      }
+    }
+    const int32_t id = static_cast<int32_t>(m_contexts.size());
+    m_contexts.emplace_back(DFACACHE::CreatePredictionContext(
+        m_builder, empty, m_builder.CreateVector(parents),
+        m_builder.CreateVector(returnStates)));
+    m_ids.emplace(context, id);
+  }
+
+  flatbuffers::FlatBufferBuilder& m_builder;
+  std::unordered_map<const antlr4::atn::PredictionContext*, int32_t> m_ids;
+  std::vector<ContextOffset> m_contexts;
+};
+}  // namespace
+
+DFACache::DFACache(CommandLineParser* clp, SymbolTable* symbolTable)
+    : m_commandLineParser(clp), m_symbolTable(symbolTable) {}
+
+PathId DFACache::getCacheFileId_(std::string_view grammar) const {
+  PathId cacheDirId = m_commandLineParser->getDfaCacheDirId();
+  if (!cacheDirId) return BadPathId;
+  FileSystem* const fileSystem = FileSystem::getInstance();
+  return fileSystem->getChild(cacheDirId, StrCat(grammar, ".sldf"),
+                              m_symbolTable);
+}
+
+bool DFACache::checkCacheIsValid_(antlr4::Parser* parser,
+                                  std::string_view grammar,
+                                  const std::vector<char>& content) const {
+  if (content.empty()) return false;
+  if (!DFACACHE::DFACacheBufferHasIdentifier(content.data())) return false;
+
+  const DFACACHE::DFACache* dfaCache = DFACACHE::GetDFACache(content.data());
+  if (!checkIfCacheIsValid(dfaCache->header(), FlbSchemaVersion, BadPathId,
+                           BadPathId)) {
+    return false;
+  }
+  if (dfaCache->grammar()->string_view() != grammar) return false;
+  return dfaCache->grammar_fingerprint() == grammarFingerprint(parser);
+}
+
+bool DFACache::restore_(antlr4::Parser* parser,
+                        const std::vector<char>& content) {
+  const DFACACHE::DFACache* dfaCache = DFACACHE::GetDFACache(content.data());
+  const antlr4::atn::ATN& atn = parser->getATN();
+  antlr4::atn::ParserATNSimulator* interpreter =
+      parser->getInterpreter<antlr4::atn::ParserATNSimulator>();
+
+  /* Restore the prediction context graph */
+  std::vector<PredictionContextRef> contexts;
+  contexts.reserve(dfaCache->contexts()->size());
+  for (const auto* contextFlb : *dfaCache->contexts()) {
+    if (contextFlb->empty()) {
+      contexts.emplace_back(antlr4::atn::PredictionContext::EMPTY);
+      continue;
+    }
+    std::vector<PredictionContextRef> parents;
+    std::vector<size_t> returnStates;
+    for (size_t i = 0; i < contextFlb->parents()->size(); ++i) {
+      const int32_t parent = contextFlb->parents()->Get(i);
+      if (parent >= static_cast<int32_t>(contexts.size())) return false;
+      parents.emplace_back(parent < 0 ? nullptr : contexts[parent]);
+      returnStates.emplace_back(contextFlb->return_states()->Get(i));
+    }
+    if (parents.size() == 1) {
+      contexts.emplace_back(antlr4::atn::SingletonPredictionContext::create(
+          parents.front(), returnStates.front()));
+    } else {
+      contexts.emplace_back(std::make_shared<antlr4::atn::ArrayPredictionContext>(
+          std::move(parents), std::move(returnStates)));
+    }
+  }
+
+  /* Restore the DFA states, decision by decision */
+  for (const auto* decisionFlb : *dfaCache->decisions()) {
+    if (decisionFlb->decision() >= interpreter->decisionToDFA.size()) {
+      return false;
+    }
+    antlr4::dfa::DFA& dfa = interpreter->decisionToDFA[decisionFlb->decision()];
+    std::vector<antlr4::dfa::DFAState*> states;
+    states.reserve(decisionFlb->states()->size());
+    for (const auto* stateFlb : *decisionFlb->states()) {
+      auto configs =
+          std::make_unique<antlr4::atn::ATNConfigSet>(stateFlb->full_ctx());
+      for (const auto* configFlb : *stateFlb->configs()) {
+        if (configFlb->state() >= atn.states.size() ||
+            configFlb->context() >= contexts.size()) {
+          return false;
+        }
+        auto config = std::make_shared<antlr4::atn::ATNConfig>(
+            atn.states[configFlb->state()], configFlb->alt(),
+            contexts[configFlb->context()]);
+        config->reachesIntoOuterContext =
+            configFlb->reaches_into_outer_context();
+        configs->add(config);
+      }
+      configs->uniqueAlt = stateFlb->unique_alt();
+      for (uint32_t alt : *stateFlb->conflicting_alts()) {
+        if (alt < configs->conflictingAlts.size()) {
+          configs->conflictingAlts.set(alt);
+        }
+      }
+      configs->dipsIntoOuterContext = stateFlb->dips_into_outer_context();
+      configs->optimizeConfigs(interpreter);
+      configs->setReadonly(true);
+
+      antlr4::dfa::DFAState* state =
+          new antlr4::dfa::DFAState(std::move(configs));
+      state->isAcceptState = stateFlb->is_accept_state();
+      state->prediction = stateFlb->prediction();
+      state->requiresFullContext = stateFlb->requires_full_context();
+      auto inserted = dfa.states.insert(state);
+      if (inserted.second) {
+        state->stateNumber = static_cast<int>(dfa.states.size() - 1);
+        m_stateCount++;
+      } else {
+        // Already learned in this process
+        delete state;
+        state = *inserted.first;
+      }
+      states.emplace_back(state);
+    }
+
+    // Edges are only added when missing, never overriding what the
+    // runtime computed itself.
+    for (size_t i = 0; i < states.size(); ++i) {
+      for (const auto* edge : *decisionFlb->states()->Get(i)->edges()) {
+        if (edge->target() >= states.size()) return false;
+        states[i]->edges.emplace(edge->symbol(), states[edge->target()]);
+      }
+    }
+    if (dfa.isPrecedenceDfa()) {
+      for (const auto* edge : *decisionFlb->precedence_edges()) {
+        if (edge->target() >= states.size()) return false;
+        dfa.s0->edges.emplace(edge->symbol(), states[edge->target()]);
+      }
+    } else if (decisionFlb->s0() >= 0 && dfa.s0 == nullptr) {
+      if (decisionFlb->s0() >= static_cast<int32_t>(states.size())) {
+        return false;
+      }
+      dfa.s0 = states[decisionFlb->s0()];
+    }
+  }
+  return true;
+}
+
+bool DFACache::restore(antlr4::Parser* parser, std::string_view grammar) {
+  m_stateCount = 0;
+  PathId cacheFileId = getCacheFileId_(grammar);
+  std::vector<char> content;
+  return cacheFileId && openFlatBuffers(cacheFileId, content) &&
+         checkCacheIsValid_(parser, grammar, content) &&
+         restore_(parser, content);
+}
+
+bool DFACache::save(antlr4::Parser* parser, std::string_view grammar) {
+  m_stateCount = 0;
+  PathId cacheFileId = getCacheFileId_(grammar);
+  if (!cacheFileId) return false;
+
+  antlr4::atn::ParserATNSimulator* interpreter =
+      parser->getInterpreter<antlr4::atn::ParserATNSimulator>();
+
+  flatbuffers::FlatBufferBuilder builder(1024 * 1024);
+  /* Create header section */
+  auto header = createHeader(builder, FlbSchemaVersion);
+  auto grammarName = builder.CreateString(grammar);
+
+  ContextWriter contextWriter(builder);
+  std::vector<flatbuffers::Offset<DFACACHE::Decision>> decision_vec;
+  for (antlr4::dfa::DFA& dfa : interpreter->decisionToDFA) {
+    // States guarded by semantic predicates are not persisted, the runtime
+    // recomputes them (and any edge leading to them) on demand.
+    std::vector<const antlr4::dfa::DFAState*> states;
+    std::unordered_map<const antlr4::dfa::DFAState*, uint32_t> stateIds;
+    for (const antlr4::dfa::DFAState* state : dfa.states) {
+      if (state->configs == nullptr || state->configs->hasSemanticContext ||
+          !state->predicates.empty()) {
+        continue;
+      }
+      stateIds.emplace(state, static_cast<uint32_t>(states.size()));
+      states.emplace_back(state);
+    }
+    if (states.empty()) continue;
+
+    auto cacheEdges = [&stateIds](const antlr4::dfa::DFAState* state) {
+      std::vector<DFACACHE::Edge> edges;
+      for (const auto& [symbol, target] : state->edges) {
+        auto found = stateIds.find(target);
+        if (found != stateIds.end()) {
+          edges.emplace_back(symbol, found->second);
+        }
+      }
+      return edges;
+    };
+
+    std::vector<flatbuffers::Offset<DFACACHE::DFAState>> state_vec;
+    for (const antlr4::dfa::DFAState* state : states) {
+      const antlr4::atn::ATNConfigSet* configs = state->configs.get();
+      std::vector<DFACACHE::ATNConfig> config_vec;
+      for (const auto& config : configs->configs) {
+        config_vec.emplace_back(
+            static_cast<uint32_t>(config->state->stateNumber),
+            static_cast<uint32_t>(config->alt),
+            static_cast<uint32_t>(contextWriter.write(config->context)),
+            config->reachesIntoOuterContext);
+      }
+      std::vector<uint32_t> conflicting_vec;
+      for (size_t alt = 0; alt < configs->conflictingAlts.size(); ++alt) {
+        if (configs->conflictingAlts.test(alt)) {
+          conflicting_vec.emplace_back(static_cast<uint32_t>(alt));
+        }
+      }
+      auto configList = builder.CreateVectorOfStructs(config_vec);
+      auto conflictingList = builder.CreateVector(conflicting_vec);
+      auto edgeList = builder.CreateVectorOfStructs(cacheEdges(state));
+      state_vec.emplace_back(DFACACHE::CreateDFAState(
+          builder, configList, configs->fullCtx, configs->uniqueAlt,
+          conflictingList, configs->dipsIntoOuterContext, state->isAcceptState,
+          state->prediction, state->requiresFullContext, edgeList));
+    }
+    m_stateCount += states.size();
+
+    int32_t s0 = -1;
+    std::vector<DFACACHE::Edge> precedence_vec;
+    if (dfa.isPrecedenceDfa()) {
+      if (dfa.s0 != nullptr) precedence_vec = cacheEdges(dfa.s0);
+    } else if (dfa.s0 != nullptr) {
+      auto found = stateIds.find(dfa.s0);
+      if (found != stateIds.end()) s0 = static_cast<int32_t>(found->second);
+    }
+    auto precedenceList = builder.CreateVectorOfStructs(precedence_vec);
+    auto stateList = builder.CreateVector(state_vec);
+    decision_vec.emplace_back(DFACACHE::CreateDecision(
+        builder, static_cast<uint32_t>(dfa.decision), s0, precedenceList,
+        stateList));
+  }
+  auto contextList = builder.CreateVector(contextWriter.getContexts());
+  auto decisionList = builder.CreateVector(decision_vec);
+
+  auto dfaCache =
+      DFACACHE::CreateDFACache(builder, header, grammarName,
+                               grammarFingerprint(parser), contextList,
+                               decisionList);
+  FinishDFACacheBuffer(builder, dfaCache);
+
+  /* Save Flatbuffer */
+  // Concurrent runs can share the directory: each one writes its own
+  // temporary file and renames it over the cache, so that a reader only
+  // ever sees a complete file.
+  FileSystem* const fileSystem = FileSystem::getInstance();
+  PathId tmpFileId = fileSystem->getChild(
+      m_commandLineParser->getDfaCacheDirId(),
+      StrCat(grammar, ".sldf.", std::random_device{}(), ".tmp"),
+      m_symbolTable);
+  if (saveFlatbuffers(builder, tmpFileId, m_symbolTable) &&
+      fileSystem->rename(tmpFileId, cacheFileId)) {
+    return true;
+  }
+  fileSystem->remove(tmpFileId);
+  return false;
+}
+
+}  // namespace SURELOG
@@ -0,0 +1,152 @@
+/*
+ Copyright 2021 Alain Dargelas
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include <Surelog/Cache/DFACache.h>
+#include <Surelog/CommandLine/CommandLineParser.h>
+#include <Surelog/Common/PlatformFileSystem.h>
+#include <Surelog/ErrorReporting/ErrorContainer.h>
+#include <Surelog/SourceCompile/SymbolTable.h>
+#include <antlr4-runtime.h>
+#include <gtest/gtest.h>
+#include <parser/SV3_1aLexer.h>
+#include <parser/SV3_1aParser.h>
+#include <parser/SV3_1aPpLexer.h>
+#include <parser/SV3_1aPpParser.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SURELOG {
+
+namespace fs = std::filesystem;
+
+namespace {
+class TestFileSystem : public PlatformFileSystem {
+ public:
+  explicit TestFileSystem(const fs::path &wd) : PlatformFileSystem(wd) {
+    FileSystem::setInstance(this);
+  }
+};
+
+class DFACacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    m_baseDir = fs::path(testing::TempDir()) / "dfacache";
+    std::error_code ec;
+    fs::remove_all(m_baseDir, ec);
+    fs::create_directories(m_baseDir, ec);
+    m_fileSystem.reset(new TestFileSystem(m_baseDir));
+    m_errors.reset(new ErrorContainer(&m_symbolTable));
+    m_clp.reset(new CommandLineParser(m_errors.get(), &m_symbolTable, false,
+                                      false));
+    const std::string program = FileSystem::getProgramPath().string();
+    const std::string dir = (m_baseDir / "dfa").string();
+    const char *args[] = {program.c_str(), "-dfacache", dir.c_str()};
+    m_clp->parseCommandLine(3, args);
+  }
+
+  void TearDown() override {
+    std::error_code ec;
+    fs::remove_all(m_baseDir, ec);
+  }
+
+  fs::path m_baseDir;
+  std::unique_ptr<FileSystem> m_fileSystem;
+  SymbolTable m_symbolTable;
+  std::unique_ptr<ErrorContainer> m_errors;
+  std::unique_ptr<CommandLineParser> m_clp;
+};
+
+// The prediction DFA is static to a generated parser class: parsing with
+// any instance fills it, clearDFA() makes every instance cold again.
+void learn(SV3_1aParser *parser) {
+  parser->getInterpreter<antlr4::atn::ParserATNSimulator>()->clearDFA();
+  parser->top_level_rule();
+  parser->reset();
+}
+
+TEST_F(DFACacheTest, SaveRestoreRoundTrip) {
+  antlr4::ANTLRInputStream input(
+      "module top(input a, b); wire c = a & b;\n"
+      "  always @(posedge a) if (b) c <= !c;\n"
+      "endmodule\n");
+  SV3_1aLexer lexer(&input);
+  antlr4::CommonTokenStream tokens(&lexer);
+  SV3_1aParser parser(&tokens);
+  learn(&parser);
+
+  DFACache cache(m_clp.get(), &m_symbolTable);
+  ASSERT_TRUE(cache.save(&parser, "SV3_1aParser"));
+  const uint64_t saved = cache.getStateCount();
+  EXPECT_GT(saved, 0u);
+  EXPECT_TRUE(fs::exists(m_baseDir / "dfa" / "SV3_1aParser.sldf"));
+
+  // A cold parser gets every saved state back
+  parser.getInterpreter<antlr4::atn::ParserATNSimulator>()->clearDFA();
+  ASSERT_TRUE(cache.restore(&parser, "SV3_1aParser"));
+  EXPECT_EQ(cache.getStateCount(), saved);
+
+  // A warm one already has them
+  ASSERT_TRUE(cache.restore(&parser, "SV3_1aParser"));
+  EXPECT_EQ(cache.getStateCount(), 0u);
+
+  // The restored DFA saves to the same states and still parses
+  ASSERT_TRUE(cache.save(&parser, "SV3_1aParser"));
+  EXPECT_EQ(cache.getStateCount(), saved);
+  tokens.seek(0);
+  parser.top_level_rule();
+  EXPECT_EQ(parser.getNumberOfSyntaxErrors(), 0u);
+
+  // Only the cache file is left, no temporary
+  std::vector<std::string> files;
+  for (const auto &entry : fs::directory_iterator(m_baseDir / "dfa")) {
+    files.emplace_back(entry.path().filename().string());
+  }
+  EXPECT_EQ(files, std::vector<std::string>{"SV3_1aParser.sldf"});
+}
+
+TEST_F(DFACacheTest, RejectsOtherGrammar) {
+  antlr4::ANTLRInputStream input("module top(); endmodule\n");
+  SV3_1aLexer lexer(&input);
+  antlr4::CommonTokenStream tokens(&lexer);
+  SV3_1aParser parser(&tokens);
+  learn(&parser);
+
+  DFACache cache(m_clp.get(), &m_symbolTable);
+  ASSERT_TRUE(cache.save(&parser, "SV3_1aParser"));
+
+  // Same cache file name, different grammar: the fingerprint differs
+  antlr4::ANTLRInputStream ppInput("`define A 1\n");
+  SV3_1aPpLexer ppLexer(&ppInput);
+  antlr4::CommonTokenStream ppTokens(&ppLexer);
+  SV3_1aPpParser ppParser(&ppTokens);
+  EXPECT_FALSE(cache.restore(&ppParser, "SV3_1aParser"));
+  EXPECT_EQ(cache.getStateCount(), 0u);
+
+  // A cache file saved under another grammar name
+  std::error_code ec;
+  fs::copy_file(m_baseDir / "dfa" / "SV3_1aParser.sldf",
+                m_baseDir / "dfa" / "SV3_1aPpParser.sldf", ec);
+  ASSERT_FALSE(ec);
+  EXPECT_FALSE(cache.restore(&ppParser, "SV3_1aPpParser"));
+
+  // No cache file at all
+  EXPECT_FALSE(cache.restore(&parser, "Unknown"));
+}
+}  // namespace
+}  // namespace SURELOG
@@ -39,7 +39,7 @@
 #include <iostream>
 
 namespace SURELOG {
-static constexpr std::string_view FlbSchemaVersion = "1.5";
+static constexpr std::string_view FlbSchemaVersion = "1.6";
 static constexpr std::string_view UnknownRawPath = "<unknown>";
 
 PPCache::PPCache(PreprocessFile* pp) : m_pp(pp) {}
@@ -100,10 +100,13 @@ bool PPCache::restore_(PathId cacheFileId, const std::vector<char>& content,
     for (const auto* macro_arg : *macro->arguments()) {
       args.emplace_back(macro_arg->string_view());
     }
+    const std::string_view macroBody = macro->body()->string_view();
     std::vector<std::string> tokens;
-    tokens.reserve(macro->tokens()->size());
-    for (const auto* macro_token : *macro->tokens()) {
-      tokens.emplace_back(macro_token->string_view());
+    tokens.reserve(macro->token_ends()->size());
+    uint32_t start = 0;
+    for (uint32_t end : *macro->token_ends()) {
+      tokens.emplace_back(macroBody.substr(start, end - start));
+      start = end;
     }
     m_pp->recordMacro(
         cacheSymbols.getSymbol(SymbolId(macro->name_id(), UnknownRawPath)),
@@ -292,9 +295,9 @@ bool PPCache::checkCacheIsValid_(PathId cacheFileId) const {
   if (!clp->cacheAllowed() || m_pp->isMacroBody()) return false;
   if (clp->parseOnly() || clp->lowMem()) return true;
 
-  std::vector<char> content;
-  return openFlatBuffers(cacheFileId, content) &&
-         checkCacheIsValid_(cacheFileId, content);
+  std::shared_ptr<const std::vector<char>> content;
+  return openFlatBuffers(cacheFileId, isPrecompiled_(), content) &&
+         checkCacheIsValid_(cacheFileId, *content);
 }
 
 bool PPCache::isValid() {
@@ -306,11 +309,17 @@ bool PPCache::restore(bool errorsOnly) {
   if (!clp->cacheAllowed() || m_pp->isMacroBody()) return false;
 
   PathId cacheFileId = getCacheFileId_(BadPathId);
-  std::vector<char> content;
+  std::shared_ptr<const std::vector<char>> content;
 
-  return cacheFileId && openFlatBuffers(cacheFileId, content) &&
-         checkCacheIsValid_(cacheFileId, content) &&
-         restore_(cacheFileId, content, errorsOnly, 0);
+  return cacheFileId &&
+         openFlatBuffers(cacheFileId, isPrecompiled_(), content) &&
+         checkCacheIsValid_(cacheFileId, *content) &&
+         restore_(cacheFileId, *content, errorsOnly, 0);
+}
+
+bool PPCache::isPrecompiled_() const {
+  return Precompiled::getSingleton()->isFilePrecompiled(
+      m_pp->getFileId(LINE1), m_pp->getCompileSourceFile()->getSymbolTable());
 }
 
 bool PPCache::save() {
@@ -349,24 +358,14 @@ bool PPCache::save() {
       MACROCACHE::MacroType type = (info->m_type == MacroInfo::WITH_ARGS)
                                        ? MACROCACHE::MacroType_WITH_ARGS
                                        : MACROCACHE::MacroType_NO_ARGS;
-      auto args = builder.CreateVectorOfStrings(info->m_arguments);
-      /*
-      Debug code for a flatbuffer issue"
-      std::cout << "STRING VECTOR CONTENT:\n";
-      int index = 0;
-      std::cout << "VECTOR SIZE: " << info->m_tokens.size() << std::endl;
-      for (auto st : info->m_tokens) {
-        std::cout << index << " ST:" << st.size() << " >>>" << st << "<<<"
-                  << std::endl;
-        index++;
-      }
-      */
-      auto tokens = builder.CreateVectorOfStrings(info->m_tokens);
+      auto args = builder.CreateVectorOfStrings(info->getArguments());
+      auto macroBody = builder.CreateString(info->m_body);
+      auto tokenEnds = builder.CreateVector(info->m_tokenEnds);
       macro_vec.emplace_back(MACROCACHE::CreateMacro(
           builder, (RawSymbolId)cacheSymbols.registerSymbol(macroName), type,
           (RawPathId)fileSystem->copy(info->m_fileId, &cacheSymbols),
           info->m_startLine, info->m_startColumn, info->m_endLine,
-          info->m_endColumn, args, tokens));
+          info->m_endColumn, args, macroBody, tokenEnds));
     }
   }
   auto macroList = builder.CreateVector(macro_vec);
@@ -174,9 +174,9 @@ bool ParseCache::checkCacheIsValid_(PathId cacheFileId) const {
       m_parse->getCompileSourceFile()->getCommandLineParser();
   if (!clp->cacheAllowed()) return false;
 
-  std::vector<char> content;
-  return openFlatBuffers(cacheFileId, content) &&
-         checkCacheIsValid_(cacheFileId, content);
+  std::shared_ptr<const std::vector<char>> content;
+  return openFlatBuffers(cacheFileId, isPrecompiled_(), content) &&
+         checkCacheIsValid_(cacheFileId, *content);
 }
 
 bool ParseCache::isValid() {
@@ -189,11 +189,63 @@ bool ParseCache::restore() {
   if (!clp->cacheAllowed()) return false;
 
   PathId cacheFileId = getCacheFileId_(BadPathId);
+  std::shared_ptr<const std::vector<char>> content;
+
+  return cacheFileId &&
+         openFlatBuffers(cacheFileId, isPrecompiled_(), content) &&
+         checkCacheIsValid_(cacheFileId, *content) &&
+         restore_(cacheFileId, *content);
+}
+
+bool ParseCache::isPrecompiled_() const {
+  return Precompiled::getSingleton()->isFilePrecompiled(
+      m_parse->getPpFileId(),
+      m_parse->getCompileSourceFile()->getSymbolTable());
+}
+
+bool ParseCache::restoreFromFileUnit() {
+  CommandLineParser* clp =
+      m_parse->getCompileSourceFile()->getCommandLineParser();
+  if (!clp->cacheAllowed() || !clp->diffCompMode() || clp->fileunit() ||
+      clp->parseOnly())
+    return false;
+
+  const PathId ppFileId = m_parse->getPpFileId();
+  if (!ppFileId) return false;
+
+  FileSystem* const fileSystem = FileSystem::getInstance();
+  SymbolTable* const symbolTable =
+      m_parse->getCompileSourceFile()->getSymbolTable();
+  Precompiled* const prec = Precompiled::getSingleton();
+  if (prec->isFilePrecompiled(ppFileId, symbolTable)) return false;
+
+  const std::string& libName = m_parse->getLibrary()->getName();
+  const PathId unitPpFileId = fileSystem->getPpOutputFile(
+      true, m_parse->getCompileSourceFile()->getFileId(), libName,
+      symbolTable);
+  const PathId unitCacheFileId = fileSystem->getParseCacheFile(
+      true, unitPpFileId, libName, false, symbolTable);
+  if (!unitPpFileId || !unitCacheFileId || (unitPpFileId == ppFileId))
+    return false;
+
+  std::string allText;
+  std::string unitText;
+  if (!fileSystem->readContent(ppFileId, allText) ||
+      !fileSystem->readContent(unitPpFileId, unitText) ||
+      (allText != unitText))
+    return false;
+
   std::vector<char> content;
+  if (!openFlatBuffers(unitCacheFileId, content) ||
+      !PARSECACHE::ParseCacheBufferHasIdentifier(content.data()))
+    return false;
+  const PARSECACHE::ParseCache* ppcache =
+      PARSECACHE::GetParseCache(content.data());
+  if (!checkIfCacheIsValid(ppcache->header(), FlbSchemaVersion,
+                           unitCacheFileId, unitPpFileId))
+    return false;
 
-  return cacheFileId && openFlatBuffers(cacheFileId, content) &&
-         checkCacheIsValid_(cacheFileId, content) &&
-         restore_(cacheFileId, content);
+  return restore_(unitCacheFileId, content);
 }
 
 bool ParseCache::save() {
@@ -139,6 +139,9 @@ static const std::initializer_list<std::string_view> helpText = {
     "  -link                 Link and elaborate the separately compiled files",
     "  -elabuhdm             Forces UHDM/VPI Full Elaboration, default is the",
     "                        Folded Model",
+    "  -lazyelabuhdm         UHDM/VPI Full Elaboration on demand: the Folded",
+    "                        Model is written and each top level instance is",
+    "                        elaborated when first requested through the API",
     "  -nouhdm               No UHDM db write",
     "  -top/--top-module <module>",
     "                        Top level module for elaboration",
@@ -178,6 +181,19 @@ static const std::initializer_list<std::string_view> helpText = {
     "  -lowmem               Minimizes memory high water mark (uses multiple",
     "                        staggered processes for preproc, parsing and",
     "                        elaboration)",
+    "  -boundedmem <nb_files>",
+    "                        Frees each file's parse tree and tokens as soon",
+    "                        as its AST is built and caps the number of files",
+    "                        being tokenized/parsed at once (0 is no cap).",
+    "                        The preprocessor data is freed before the UHDM",
+    "                        model is built and saved",
+    "  -specpp               Multithreaded runs preprocess the files of the",
+    "                        compilation unit speculatively in parallel, and",
+    "                        preprocess again the ones the earlier files",
+    "                        invalidate",
+    "  -macroexp             Expand macro bodies without directives, comments",
+    "                        or nested macro calls directly instead of running",
+    "                        them through the preprocessor grammar",
     "  -split <line number>  Split files or modules larger than specified",
     "                        line number for multi thread compilation",
     "  -timescale=<timescale>",
@@ -209,6 +225,9 @@ static const std::initializer_list<std::string_view> helpText = {
     "  -nohash               Treat cache as always valid (no",
     "                        timestamp/dependancy check)",
     "  -createcache          Create cache for precompiled packages",
+    "  -dfacache <dir>       Restores the parser's prediction DFA from <dir>",
+    "                        at startup and saves it back after parsing.",
+    "                        Warm-starts the parsers across runs",
     "  -filterdirectives     Filters out simple directives like",
     "                        `default_nettype in pre-processor's output",
     "  -filterprotected      Filters out protected regions in pre-processor's",
@@ -384,12 +403,18 @@ CommandLineParser::CommandLineParser(ErrorContainer* errors,
       m_sverilog(false),
       m_dumpUhdm(false),
       m_elabUhdm(false),
+      m_lazyElabUhdm(false),
       m_coverUhdm(false),
       m_showVpiIDs(false),
       m_replay(false),
       m_uhdmStats(false),
       m_lowMem(false),
+      m_boundedMem(false),
+      m_maxTokenizedFiles(0),
+      m_speculativePreprocess(false),
+      m_macroExpander(false),
       m_writeUhdm(true),
+      m_lateBindPerDefinition(true),
       m_nonSynthesizable(false),
       m_nonSynthesizableWithFormal(false),
       m_noCacheHash(false),
@@ -1003,6 +1028,20 @@ bool CommandLineParser::parseCommandLine(int argc, const char** argv) {
       }
       i++;
       m_nbLinesForFileSplitting = std::stoi(all_arguments[i]);
+    } else if (all_arguments[i] == "-boundedmem") {
+      if (i == all_arguments.size() - 1) {
+        Location loc(m_symbolTable->registerSymbol(all_arguments[i]));
+        Error err(ErrorDefinition::CMD_BOUNDEDMEM_MISSING_SIZE, loc);
+        m_errors->addError(err);
+        break;
+      }
+      i++;
+      m_boundedMem = true;
+      m_maxTokenizedFiles = std::stoi(all_arguments[i]);
+    } else if (all_arguments[i] == "-specpp") {
+      m_speculativePreprocess = true;
+    } else if (all_arguments[i] == "-macroexp") {
+      m_macroExpander = true;
     } else if (all_arguments[i] == "-builtin") {
       i++;
     } else if (all_arguments[i] == "-exe") {
@@ -1180,6 +1219,20 @@ bool CommandLineParser::parseCommandLine(int argc, const char** argv) {
       } else {
         m_cacheDirId = fileSystem->toPathId(dirpath.string(), m_symbolTable);
       }
+    } else if (all_arguments[i] == "-dfacache") {
+      if (i == all_arguments.size() - 1) {
+        Location loc(m_symbolTable->registerSymbol(all_arguments[i]));
+        Error err(ErrorDefinition::CMD_PP_FILE_MISSING_FILE, loc);
+        m_errors->addError(err);
+        break;
+      }
+      fs::path dirpath = FileSystem::normalize(all_arguments[++i]);
+      if (dirpath.is_relative()) {
+        m_dfaCacheDirId = fileSystem->getChild(m_outputDirId, dirpath.string(),
+                                               m_symbolTable);
+      } else {
+        m_dfaCacheDirId = fileSystem->toPathId(dirpath.string(), m_symbolTable);
+      }
     } else if (all_arguments[i] == "-replay") {
       m_replay = true;
     } else if (all_arguments[i] == "-writepp") {
@@ -1260,6 +1313,7 @@ bool CommandLineParser::parseCommandLine(int argc, const char** argv) {
       m_compile = false;
       m_elaborate = false;
       m_elabUhdm = false;
+      m_lazyElabUhdm = false;
       m_writeUhdm = false;
       m_parseBuiltIn = false;
     } else if (all_arguments[i] == "-noparse") {
@@ -1274,6 +1328,9 @@ bool CommandLineParser::parseCommandLine(int argc, const char** argv) {
     } else if (all_arguments[i] == "-elabuhdm") {
       m_elaborate = true;
       m_elabUhdm = true;
+    } else if (all_arguments[i] == "-lazyelabuhdm") {
+      m_elaborate = true;
+      m_lazyElabUhdm = true;
     } else if (all_arguments[i] == "-pploc") {
       m_ppOutputFileLocation = true;
     } else if (all_arguments[i] == "-pythonlistener") {
@@ -25,6 +25,8 @@
 #include <Surelog/SourceCompile/SymbolTable.h>
 #include <Surelog/Utils/StringUtils.h>
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
 #include <iostream>
 #include <regex>
@@ -139,6 +141,7 @@ std::ostream &PlatformFileSystem::openOutput(
     const std::filesystem::path &filepath, std::ios_base::openmode mode) {
   if (!filepath.is_absolute()) return m_nullOutputStream;
 
+  invalidateEntry_(filepath);
   std::scoped_lock<std::mutex> lock(m_outputStreamsMutex);
   std::pair<OutputStreams::iterator, bool> it =
       m_outputStreams.emplace(new std::ofstream);
@@ -657,6 +660,8 @@ bool PlatformFileSystem::rename(PathId whatId, PathId toId) {
 
   if (what.empty() || to.empty()) return false;
 
+  invalidateEntry_(what);
+  invalidateEntry_(to);
   std::error_code ec;
   std::filesystem::rename(what, to, ec);
   return !ec;
@@ -673,6 +678,7 @@ bool PlatformFileSystem::remove(PathId fileId) {
     return true;
   }
 
+  invalidateEntry_(file);
   if (!std::filesystem::remove(file, ec) && ec) {
     return false;
   }
@@ -692,6 +698,7 @@ bool PlatformFileSystem::mkdir(PathId dirId) {
     return true;
   }
 
+  invalidateEntry_(dir);
   if (!std::filesystem::create_directory(dir, ec) || ec) {
     return false;
   }
@@ -711,6 +718,7 @@ bool PlatformFileSystem::rmdir(PathId dirId) {
     return true;
   }
 
+  invalidateEntry_(dir);
   if (!std::filesystem::remove(dir, ec) || ec) {
     return false;
   }
@@ -734,6 +742,14 @@ bool PlatformFileSystem::mkdirs(PathId dirId) {
   // slash in the path will cause a false return from a call to
   // fs::create_directories.
   // if (!std::filesystem::create_directories(dir, ec) || ec) {
+  // All the created directories are below the first missing one
+  std::filesystem::path created = dir;
+  while (created.has_relative_path() &&
+         !std::filesystem::exists(created.parent_path(), ec) && !ec) {
+    created = created.parent_path();
+  }
+  ec.clear();
+  invalidateEntry_(created);
   std::filesystem::create_directories(dir, ec);
   if (ec) return false;
 
@@ -752,6 +768,7 @@ bool PlatformFileSystem::rmtree(PathId dirId) {
     return true;
   }
 
+  invalidateEntry_(dir);
   if (!std::filesystem::remove_all(dir, ec) || ec) {
     return false;
   }
@@ -832,23 +849,201 @@ std::filesystem::file_time_type PlatformFileSystem::modtime(
   return ec ? defaultOnFail : lmt;
 }
 
+// Case insensitive file systems find "Foo.svh" when asked for "foo.svh"
+static std::string toListingName(std::string_view name) {
+  std::string listingName(name);
+#if defined(_WIN32) || defined(__APPLE__)
+  std::transform(listingName.begin(), listingName.end(), listingName.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+#endif
+  return listingName;
+}
+
+// True if the normalized 'path' is the normalized 'dirpath' or below it
+static bool isSameOrBelow(std::string_view path, std::string_view dirpath) {
+  if (dirpath.empty() || (path.compare(0, dirpath.size(), dirpath) != 0)) {
+    return false;
+  }
+  if (path.size() == dirpath.size()) return true;
+  auto isSeparator = [](char c) { return (c == '/') || (c == '\\'); };
+  return isSeparator(path[dirpath.size()]) || isSeparator(dirpath.back());
+}
+
 PathId PlatformFileSystem::locate(std::string_view name,
                                   const PathIdVector &directories,
                                   SymbolTable *symbolTable) {
   if (name.empty()) return BadPathId;
 
-  std::error_code ec;
-  for (const PathId &dirId : directories) {
-    if (dirId) {
-      const std::filesystem::path filepath =
-          normalize(std::filesystem::path(toPath(dirId)) / name);
-      if (!filepath.empty() && std::filesystem::exists(filepath, ec) && !ec) {
-        return toPathId(filepath.string(), symbolTable);
+  // Only names made of plain components are cached and looked up in the
+  // directory listings, absolute names and "."/".." don't resolve under the
+  // directory
+  const std::filesystem::path namepath(name);
+  std::string firstComponent;
+  if (namepath.is_relative()) {
+    for (const std::filesystem::path &component : namepath) {
+      const std::string componentName = component.string();
+      if ((componentName == ".") || (componentName == "..")) {
+        firstComponent.clear();
+        break;
+      }
+      if (firstComponent.empty()) firstComponent = toListingName(componentName);
+    }
+  }
+  const std::string key =
+      firstComponent.empty() ? std::string()
+                             : namepath.lexically_normal().generic_string();
+
+  std::string found;
+  {
+    std::scoped_lock<std::mutex> lock(m_locateMutex);
+    SearchPath &searchPath = getSearchPath_(directories);
+    auto it = key.empty() ? searchPath.m_results.end()
+                          : searchPath.m_results.find(key);
+    if (it != searchPath.m_results.end()) {
+      found = it->second;
+    } else {
+      std::error_code ec;
+      for (const std::string &dirpath : searchPath.m_normalized) {
+        if (dirpath.empty()) continue;
+        if (!key.empty()) {
+          const DirectoryListing &listing = getDirectoryListing_(dirpath);
+          if (listing.m_indexed &&
+              (listing.m_names.find(firstComponent) == listing.m_names.end()))
+            continue;
+        }
+        const std::filesystem::path filepath =
+            normalize(std::filesystem::path(dirpath) / name);
+        if (!filepath.empty() && std::filesystem::exists(filepath, ec) &&
+            !ec) {
+          found = filepath.string();
+          break;
+        }
       }
+      if (!key.empty()) searchPath.m_results.emplace(key, found);
+    }
+  }
+
+  return found.empty() ? BadPathId : toPathId(found, symbolTable);
+}
+
+PlatformFileSystem::SearchPath &PlatformFileSystem::getSearchPath_(
+    const PathIdVector &directories) {
+  size_t hash = directories.size();
+  for (const PathId &dirId : directories) {
+    const std::string_view dirpath = dirId ? toPath(dirId) : std::string_view();
+    hash = (hash * 31) + std::hash<std::string_view>()(dirpath);
+  }
+  auto range = m_searchPaths.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const std::vector<std::string> &known = it->second.m_directories;
+    if ((known.size() == directories.size()) &&
+        std::equal(known.begin(), known.end(), directories.begin(),
+                   [this](const std::string &dirpath, const PathId &dirId) {
+                     return dirpath == (dirId ? toPath(dirId)
+                                              : std::string_view());
+                   })) {
+      return it->second;
     }
   }
+  SearchPath &searchPath = m_searchPaths.emplace(hash, SearchPath())->second;
+  searchPath.m_directories.reserve(directories.size());
+  searchPath.m_normalized.reserve(directories.size());
+  for (const PathId &dirId : directories) {
+    const std::string_view dirpath = dirId ? toPath(dirId) : std::string_view();
+    searchPath.m_directories.emplace_back(dirpath);
+    searchPath.m_normalized.emplace_back(
+        dirpath.empty() ? std::string()
+                        : normalize(std::filesystem::path(dirpath)).string());
+  }
+  return searchPath;
+}
+
+const PlatformFileSystem::DirectoryListing &
+PlatformFileSystem::getDirectoryListing_(const std::string &dirpath) {
+  auto [it, inserted] = m_directoryListings.try_emplace(dirpath);
+  DirectoryListing &listing = it->second;
+  if (!inserted) return listing;
+
+  std::error_code ec;
+  std::filesystem::directory_iterator entries(dirpath, ec);
+  if (ec) {
+    // A missing directory has nothing to offer, anything else (permissions,
+    // ...) falls back to probing the file system
+    listing.m_indexed = (ec == std::errc::no_such_file_or_directory) ||
+                        (ec == std::errc::not_a_directory);
+    return listing;
+  }
+  for (; entries != std::filesystem::directory_iterator();
+       entries.increment(ec)) {
+    if (ec) break;
+    listing.m_names.emplace(
+        toListingName(entries->path().filename().string()));
+  }
+  listing.m_indexed = !ec;
+  if (!listing.m_indexed) listing.m_names.clear();
+  return listing;
+}
+
+// Drops the results of 'name' and of the names below it, "." drops them all
+static void eraseLocateResults(
+    std::map<std::string, std::string, std::less<>> &results,
+    const std::string &name) {
+  if (name == ".") {
+    results.clear();
+    return;
+  }
+#if defined(_WIN32) || defined(__APPLE__)
+  const std::string listingName = toListingName(name);
+  for (auto it = results.begin(); it != results.end();) {
+    const std::string resultName = toListingName(it->first);
+    if (isSameOrBelow(resultName, listingName)) {
+      it = results.erase(it);
+    } else {
+      ++it;
+    }
+  }
+#else
+  results.erase(name);
+  const std::string prefix = name + '/';
+  for (auto it = results.lower_bound(prefix);
+       (it != results.end()) &&
+       (it->first.compare(0, prefix.size(), prefix) == 0);) {
+    it = results.erase(it);
+  }
+#endif
+}
+
+void PlatformFileSystem::invalidateEntry_(const std::filesystem::path &path) {
+  const std::filesystem::path entry = normalize(path);
+  const std::string entrypath = entry.string();
+  std::scoped_lock<std::mutex> lock(m_locateMutex);
+  // The listing of the parent directory, and those of the entry and its
+  // descendants when the entry is a directory
+  m_directoryListings.erase(entry.parent_path().string());
+  for (auto it = m_directoryListings.begin();
+       it != m_directoryListings.end();) {
+    if (isSameOrBelow(it->first, entrypath)) {
+      it = m_directoryListings.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  // The results of the names that resolve to the entry or below it, in the
+  // directories above it
+  for (auto &[hash, searchPath] : m_searchPaths) {
+    if (searchPath.m_results.empty()) continue;
+    for (const std::string &dirpath : searchPath.m_normalized) {
+      if (!isSameOrBelow(entrypath, dirpath)) continue;
+      eraseLocateResults(searchPath.m_results,
+                         entry.lexically_relative(dirpath).generic_string());
+    }
+  }
+}
 
-  return BadPathId;
+void PlatformFileSystem::invalidateLocateCache() {
+  std::scoped_lock<std::mutex> lock(m_locateMutex);
+  m_directoryListings.clear();
+  m_searchPaths.clear();
 }
 
 PathIdVector &PlatformFileSystem::collect(PathId dirId,
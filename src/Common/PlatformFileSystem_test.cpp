@@ -246,6 +246,12 @@ TEST(PlatformFileSystemTest, LocateFile) {
       FileSystem::normalize(actual_dir_1 / search_file);
   std::ofstream(actual_loc_1).close();
 
+  // Files created behind the back of the file system are only seen once the
+  // locate cache is invalidated.
+  EXPECT_EQ(fileSystem->locate(search_file, directories, symbolTable.get()),
+            BadPathId);
+  fileSystem->invalidateLocateCache();
+
   PathId now_exists =
       fileSystem->locate(search_file, directories, symbolTable.get());
   EXPECT_NE(now_exists, BadPathId);
@@ -257,6 +263,7 @@ TEST(PlatformFileSystemTest, LocateFile) {
 
   const fs::path actual_loc_2 = actual_dir_2 / search_file;
   std::ofstream(actual_loc_2).close();
+  fileSystem->invalidateLocateCache();
 
   PathId now_exists_1 =
       fileSystem->locate(search_file, directories, symbolTable.get());
@@ -271,6 +278,49 @@ TEST(PlatformFileSystemTest, LocateFile) {
   EXPECT_NE(now_exists_2, BadPathId);
   EXPECT_EQ(fileSystem->toPlatformPath(now_exists_2), actual_loc_2);
 
+  // Files written through the file system are seen right away.
+  const PathId saved_id = fileSystem->toPathId(
+      (actual_dir_1 / "saved-file.txt").string(), symbolTable.get());
+  EXPECT_EQ(fileSystem->locate("saved-file.txt", directories,
+                               symbolTable.get()),
+            BadPathId);
+  EXPECT_TRUE(fileSystem->writeContent(saved_id, "content"));
+  EXPECT_EQ(fileSystem->locate("saved-file.txt", directories,
+                               symbolTable.get()),
+            saved_id);
+
+  // Writing an entry only drops the results of the names resolving to it.
+  std::ofstream(actual_dir_2 / "hidden-file.txt").close();
+  EXPECT_EQ(fileSystem->locate("hidden-file.txt", directories,
+                               symbolTable.get()),
+            BadPathId);
+  EXPECT_TRUE(fileSystem->writeContent(
+      fileSystem->toPathId((basedir / "unrelated-file.txt").string(),
+                           symbolTable.get()),
+      "content"));
+  EXPECT_TRUE(fileSystem->writeContent(
+      fileSystem->toPathId((actual_dir_1 / "other-file.txt").string(),
+                           symbolTable.get()),
+      "content"));
+  EXPECT_EQ(fileSystem->locate("hidden-file.txt", directories,
+                               symbolTable.get()),
+            BadPathId);
+
+  // Names with several components are dropped when a directory on their
+  // path is created.
+  const fs::path sub_dir = actual_dir_2 / "sub-dir";
+  const PathId sub_file_id = fileSystem->toPathId(
+      (sub_dir / "sub-file.txt").string(), symbolTable.get());
+  EXPECT_EQ(fileSystem->locate("sub-dir/sub-file.txt", directories,
+                               symbolTable.get()),
+            BadPathId);
+  EXPECT_TRUE(fileSystem->mkdirs(
+      fileSystem->toPathId(sub_dir.string(), symbolTable.get())));
+  std::ofstream(sub_dir / "sub-file.txt").close();
+  EXPECT_EQ(fileSystem->locate("sub-dir/sub-file.txt", directories,
+                               symbolTable.get()),
+            sub_file_id);
+
   EXPECT_TRUE(fileSystem->rmtree(
       fileSystem->toPathId(basedir.string(), symbolTable.get())));
 }
@@ -21,20 +21,25 @@
  * Created on July 1, 2017, 1:23 PM
  */
 
+#include <Surelog/Design/DataType.h>
 #include <Surelog/Design/DefParam.h>
 #include <Surelog/Design/Design.h>
 #include <Surelog/Design/DesignComponent.h>
 #include <Surelog/Design/FileContent.h>
 #include <Surelog/Design/ModuleDefinition.h>
 #include <Surelog/Design/ModuleInstance.h>
+#include <Surelog/Design/Parameter.h>
+#include <Surelog/Design/Signal.h>
 #include <Surelog/ErrorReporting/ErrorContainer.h>
 #include <Surelog/Expression/Value.h>
 #include <Surelog/Package/Package.h>
 #include <Surelog/SourceCompile/SymbolTable.h>
 #include <Surelog/Testbench/ClassDefinition.h>
 #include <Surelog/Testbench/Program.h>
+#include <Surelog/Testbench/Variable.h>
 #include <Surelog/Utils/StringUtils.h>
 
+#include <algorithm>
 #include <queue>
 
 namespace SURELOG {
@@ -75,6 +80,19 @@ void Design::addPPFileContent(PathId fileId, FileContent* content) {
   m_mutex.unlock();
 }
 
+void Design::removePPFileContents(const SymbolTable* symbolTable) {
+  m_mutex.lock();
+  auto it = std::remove_if(m_ppFileContents.begin(), m_ppFileContents.end(),
+                           [symbolTable](const auto& elem) {
+                             if (elem.second->getSymbolTable() != symbolTable)
+                               return false;
+                             delete elem.second;
+                             return true;
+                           });
+  m_ppFileContents.erase(it, m_ppFileContents.end());
+  m_mutex.unlock();
+}
+
 DesignComponent* Design::getComponentDefinition(
     const std::string& componentName) const {
   DesignComponent* comp = (DesignComponent*)getModuleDefinition(componentName);
@@ -96,6 +114,23 @@ ModuleDefinition* Design::getModuleDefinition(
   return nullptr;
 }
 
+template <typename T>
+static void reportArena(std::string& report, std::string_view name,
+                         const TypedArena<T>& arena) {
+  StrAppend(&report, "  ", name, ": ", arena.getObjectCount(), " objects, ",
+            arena.getBlockCount(), " blocks, ",
+            arena.getReservedBytes() / 1024, " KB\n");
+}
+
+std::string Design::getArenaProfileInfo() const {
+  std::string report = "Design arenas:\n";
+  reportArena(report, "Signal", m_signalArena);
+  reportArena(report, "Variable", m_variableArena);
+  reportArena(report, "Parameter", m_parameterArena);
+  reportArena(report, "DataType", m_dataTypeArena);
+  return report;
+}
+
 std::string Design::reportInstanceTree() const {
   std::string tree;
   ModuleInstance* tmp;
@@ -302,8 +337,9 @@ ModuleInstance* Design::findInstance_(const std::vector<std::string>& path,
 DefParam* Design::getDefParam(const std::string& name) const {
   std::vector<std::string> vpath;
   StringUtils::tokenize(name, ".", vpath);
-  std::map<std::string, DefParam*>::const_iterator itr =
-      m_defParams.find(vpath[0]);
+  if (vpath.empty()) return nullptr;
+  DefParam::DefParamMap::const_iterator itr =
+      m_defParams.find(m_errors->getSymbolTable()->getId(vpath[0]));
   if (itr != m_defParams.end()) {
     vpath.erase(vpath.begin());
     return getDefParam_(vpath, (*itr).second);
@@ -311,6 +347,28 @@ DefParam* Design::getDefParam(const std::string& name) const {
   return nullptr;
 }
 
+DefParam* Design::getDefParam(const ModuleInstance* instance,
+                              std::string_view name) const {
+  if (m_defParams.empty()) return nullptr;
+  SymbolTable* symbols = m_errors->getSymbolTable();
+  std::vector<const ModuleInstance*> chain;
+  for (const ModuleInstance* inst = instance; inst; inst = inst->getParent()) {
+    chain.push_back(inst);
+  }
+  // Walk the trie from the top instance down, one id per level
+  const DefParam::DefParamMap* children = &m_defParams;
+  for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+    // Lookup only, an unknown instance name can't be in the trie
+    DefParam::DefParamMap::const_iterator itr =
+        children->find(symbols->getId((*it)->getInstanceName()));
+    if (itr == children->end()) return nullptr;
+    children = &(*itr).second->getChildren();
+  }
+  DefParam::DefParamMap::const_iterator itr =
+      children->find(symbols->getId(name));
+  return (itr == children->end()) ? nullptr : (*itr).second;
+}
+
 Value* Design::getDefParamValue(const std::string& name) {
   DefParam* def = getDefParam(name);
   if (def) return def->getValue();
@@ -322,8 +380,8 @@ DefParam* Design::getDefParam_(std::vector<std::string>& path,
   if (path.empty()) {
     return parent;
   }
-  std::map<std::string, DefParam*>::iterator itr =
-      parent->getChildren().find(path[0]);
+  DefParam::DefParamMap::iterator itr =
+      parent->getChildren().find(m_errors->getSymbolTable()->getId(path[0]));
   if (itr != parent->getChildren().end()) {
     path.erase(path.begin());
     return getDefParam_(path, (*itr).second);
@@ -335,13 +393,14 @@ void Design::addDefParam(const std::string& name, const FileContent* fC,
                          NodeId nodeId, Value* value) {
   std::vector<std::string> vpath;
   StringUtils::tokenize(name, ".", vpath);
-  std::map<std::string, DefParam*>::iterator itr = m_defParams.find(vpath[0]);
+  const SymbolId nameId = m_errors->getSymbolTable()->registerSymbol(vpath[0]);
+  DefParam::DefParamMap::iterator itr = m_defParams.find(nameId);
   if (itr != m_defParams.end()) {
     vpath.erase(vpath.begin());
     addDefParam_(vpath, fC, nodeId, value, (*itr).second);
   } else {
     DefParam* def = new DefParam(vpath[0]);
-    m_defParams.emplace(vpath[0], def);
+    m_defParams.emplace(nameId, def);
     vpath.erase(vpath.begin());
     addDefParam_(vpath, fC, nodeId, value, def);
   }
@@ -354,8 +413,8 @@ void Design::addDefParam_(std::vector<std::string>& path, const FileContent* fC,
     parent->setLocation(fC, nodeId);
     return;
   }
-  std::map<std::string, DefParam*>::iterator itr =
-      parent->getChildren().find(path[0]);
+  const SymbolId nameId = m_errors->getSymbolTable()->registerSymbol(path[0]);
+  DefParam::DefParamMap::iterator itr = parent->getChildren().find(nameId);
   if (itr != parent->getChildren().end()) {
     path.erase(path.begin());
     if (path.empty()) {
@@ -378,17 +437,30 @@ void Design::addDefParam_(std::vector<std::string>& path, const FileContent* fC,
     addDefParam_(path, fC, nodeId, value, (*itr).second);
   } else {
     DefParam* def = new DefParam(path[0], parent);
-    parent->setChild(path[0], def);
+    parent->setChild(nameId, def);
     path.erase(path.begin());
     addDefParam_(path, fC, nodeId, value, def);
   }
 }
 
+// The trie is keyed by symbol id, report in name order
+static std::vector<DefParam*> sortedDefParams(
+    const DefParam::DefParamMap& defParams) {
+  std::vector<DefParam*> sorted;
+  sorted.reserve(defParams.size());
+  for (const auto& defParam : defParams) sorted.push_back(defParam.second);
+  std::sort(sorted.begin(), sorted.end(),
+            [](const DefParam* lhs, const DefParam* rhs) {
+              return lhs->getName() < rhs->getName();
+            });
+  return sorted;
+}
+
 void Design::checkDefParamUsage(DefParam* parent) {
   if (parent == nullptr) {
     // Start by all the top defs of the trie
-    for (const auto& top : m_defParams) {
-      checkDefParamUsage(top.second);
+    for (DefParam* top : sortedDefParams(m_defParams)) {
+      checkDefParamUsage(top);
     }
   } else {
     // Check the leaf
@@ -411,8 +483,8 @@ void Design::checkDefParamUsage(DefParam* parent) {
       Error err(ErrorDefinition::ELAB_UNMATCHED_DEFPARAM, loc);
       m_errors->addError(err);
     }
-    for (const auto& param : parent->getChildren()) {
-      checkDefParamUsage(param.second);
+    for (DefParam* param : sortedDefParams(parent->getChildren())) {
+      checkDefParamUsage(param);
     }
   }
 }
@@ -62,7 +62,7 @@ unsigned int ModuleDefinition::getSize() const {
   return size;
 }
 
-void ModuleDefinition::insertModPort(const std::string& modport,
+void ModuleDefinition::insertModPort(std::string_view modport,
                                      const Signal& signal, NodeId nodeId) {
   ModPortSignalMap::iterator itr = m_modportSignalMap.find(modport);
   if (itr == m_modportSignalMap.end()) {
@@ -74,7 +74,7 @@ void ModuleDefinition::insertModPort(const std::string& modport,
   }
 }
 
-const Signal* ModuleDefinition::getModPortSignal(const std::string& modport,
+const Signal* ModuleDefinition::getModPortSignal(std::string_view modport,
                                                  NodeId port) const {
   ModPortSignalMap::const_iterator itr = m_modportSignalMap.find(modport);
   if (itr == m_modportSignalMap.end()) {
@@ -89,7 +89,7 @@ const Signal* ModuleDefinition::getModPortSignal(const std::string& modport,
   return nullptr;
 }
 
-ModPort* ModuleDefinition::getModPort(const std::string& modport) {
+ModPort* ModuleDefinition::getModPort(std::string_view modport) {
   ModPortSignalMap::iterator itr = m_modportSignalMap.find(modport);
   if (itr == m_modportSignalMap.end()) {
     return nullptr;
@@ -98,7 +98,7 @@ ModPort* ModuleDefinition::getModPort(const std::string& modport) {
   }
 }
 
-void ModuleDefinition::insertModPort(const std::string& modport,
+void ModuleDefinition::insertModPort(std::string_view modport,
                                      ClockingBlock& cb) {
   ModPortClockingBlockMap::iterator itr =
       m_modportClockingBlockMap.find(modport);
@@ -112,7 +112,7 @@ void ModuleDefinition::insertModPort(const std::string& modport,
 }
 
 const ClockingBlock* ModuleDefinition::getModPortClockingBlock(
-    const std::string& modport, NodeId port) const {
+    std::string_view modport, NodeId port) const {
   auto itr = m_modportClockingBlockMap.find(modport);
   if (itr == m_modportClockingBlockMap.end()) {
     return nullptr;
@@ -126,7 +126,7 @@ const ClockingBlock* ModuleDefinition::getModPortClockingBlock(
   return nullptr;
 }
 
-ClassDefinition* ModuleDefinition::getClassDefinition(const std::string& name) {
+ClassDefinition* ModuleDefinition::getClassDefinition(std::string_view name) {
   auto itr = m_classDefinitions.find(name);
   if (itr == m_classDefinitions.end()) {
     return nullptr;
@@ -27,6 +27,7 @@
 #include <Surelog/Design/Netlist.h>
 #include <Surelog/Expression/ExprBuilder.h>
 #include <Surelog/SourceCompile/SymbolTable.h>
+#include <Surelog/Utils/StringUtils.h>
 
 // UHDM
 #include <uhdm/constant.h>
@@ -43,17 +44,17 @@ ModuleInstance::ModuleInstance(DesignComponent* moduleDefinition,
                                const FileContent* fileContent, NodeId nodeId,
                                ModuleInstance* parent,
                                std::string_view instName,
-                               std::string_view modName)
+                               std::string_view modName, SymbolTable* symbols)
     : ValuedComponentI(parent, moduleDefinition),
       m_definition(moduleDefinition),
       m_fileContent(fileContent),
       m_nodeId(nodeId),
       m_parent(parent),
-      m_instName(instName),
+      m_symbols(symbols),
+      m_instNameId(symbols->registerSymbol(instName)),
       m_netlist(nullptr) {
   if (m_definition == nullptr) {
-    m_instName = modName;
-    m_instName.append("&").append(instName);
+    m_moduleNameId = symbols->registerSymbol(modName);
   }
 }
 
@@ -187,7 +188,7 @@ ModuleInstance* ModuleInstanceFactory::newModuleInstance(
     NodeId nodeId, ModuleInstance* parent, std::string_view instName,
     std::string_view modName) {
   return new ModuleInstance(moduleDefinition, fileContent, nodeId, parent,
-                            instName, modName);
+                            instName, modName, m_symbols);
 }
 
 VObjectType ModuleInstance::getType() const {
@@ -223,33 +224,19 @@ unsigned short ModuleInstance::getEndColumnNb() const {
 }
 
 SymbolId ModuleInstance::getFullPathId(SymbolTable* symbols) const {
-  return symbols->registerSymbol(getFullPathName());
+  const std::string& path = getFullPathName();
+  if (symbols == m_symbols) return m_fullPathId;
+  return symbols->registerSymbol(path);
 }
 
 SymbolId ModuleInstance::getInstanceId(SymbolTable* symbols) const {
+  if (symbols == m_symbols) return m_instNameId;
   return symbols->registerSymbol(getInstanceName());
 }
 SymbolId ModuleInstance::getModuleNameId(SymbolTable* symbols) const {
   return symbols->registerSymbol(getModuleName());
 }
 
-std::string ModuleInstance::getFullPathName() const {
-  std::string path;
-  const ModuleInstance* tmp = this;
-  std::vector<std::string> nibbles;
-  while (tmp) {
-    nibbles.push_back(tmp->getInstanceName());
-    tmp = tmp->getParent();
-  }
-  for (int i = nibbles.size() - 1; i >= 0; i--) {
-    path += nibbles[i];
-    if (i > 0) {
-      path += ".";
-    }
-  }
-  return path;
-}
-
 unsigned int ModuleInstance::getDepth() const {
   unsigned int depth = 0;
   const ModuleInstance* tmp = this;
@@ -260,19 +247,43 @@ unsigned int ModuleInstance::getDepth() const {
   return depth;
 }
 
-std::string ModuleInstance::getInstanceName() const {
-  if (m_definition == nullptr) {
-    std::string name =
-        m_instName.substr(m_instName.find("&", 0, 1) + 1, m_instName.size());
-    return name;
-  } else {
-    return m_instName;
+const std::string& ModuleInstance::getInstanceName() const {
+  return m_symbols->getSymbol(m_instNameId);
+}
+
+const std::string& ModuleInstance::getFullPathName() const {
+  if (!m_fullPathId) {
+    m_fullPathId = (m_parent == nullptr)
+                       ? m_instNameId
+                       : m_symbols->registerSymbol(StrCat(
+                             m_parent->getFullPathName(), ".",
+                             getInstanceName()));
+  }
+  return m_symbols->getSymbol(m_fullPathId);
+}
+
+void ModuleInstance::invalidateFullPathName_() {
+  m_fullPathId = BadSymbolId;
+  for (ModuleInstance* sub : m_allSubInstances) sub->invalidateFullPathName_();
+}
+
+bool ModuleInstance::matchesFullPathName(std::string_view path) const {
+  const ModuleInstance* inst = this;
+  while (inst) {
+    const size_t dot = path.rfind('.');
+    const std::string_view name =
+        (dot == std::string_view::npos) ? path : path.substr(dot + 1);
+    if (m_symbols->getId(name) != inst->m_instNameId) return false;
+    inst = inst->m_parent;
+    if (dot == std::string_view::npos) return inst == nullptr;
+    path = path.substr(0, dot);
   }
+  return false;
 }
 
 std::string_view ModuleInstance::getModuleName() const {
   if (m_definition == nullptr) {
-    return std::string_view(m_instName).substr(0, m_instName.find("&", 0, 1));
+    return m_symbols->getSymbol(m_moduleNameId);
   } else {
     return m_definition->getName();
   }
@@ -291,6 +302,7 @@ void ModuleInstance::overrideParentChild(ModuleInstance* parent,
       return;
   }
   child->m_parent = this;
+  child->invalidateFullPathName_();
   std::vector<ModuleInstance*> children;
 
   for (ModuleInstance* sub_instance : m_allSubInstances) {
@@ -30,7 +30,7 @@ void Scope::addVariable(Variable* var) {
   m_variables.emplace(var->getName(), var);
 }
 
-Variable* Scope::getVariable(const std::string& name) {
+Variable* Scope::getVariable(std::string_view name) {
   VariableMap::iterator itr = m_variables.find(name);
   if (itr == m_variables.end()) {
     if (m_parentScope) {
@@ -43,7 +43,7 @@ Variable* Scope::getVariable(const std::string& name) {
   }
 }
 
-DataType* Scope::getUsedDataType(const std::string& name) {
+DataType* Scope::getUsedDataType(std::string_view name) {
   DataTypeMap::iterator itr = m_usedDataTypes.find(name);
   if (itr == m_usedDataTypes.end()) {
     return nullptr;
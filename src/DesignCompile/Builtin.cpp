@@ -30,6 +30,7 @@
 #include <Surelog/DesignCompile/CompilerHarness.h>
 #include <Surelog/Library/Library.h>
 #include <Surelog/Package/Package.h>
+#include <Surelog/SourceCompile/CompilationUnit.h>
 #include <Surelog/SourceCompile/Compiler.h>
 #include <Surelog/SourceCompile/ParserHarness.h>
 #include <Surelog/SourceCompile/PreprocessHarness.h>
@@ -237,8 +238,8 @@ void Builtin::addBuiltinTypes() {
       package->addClassDefinition(className, classDef);
     }
 
-    DataType* dtype = new DataType(nullptr, InvalidNodeId, returnTypeName,
-                                   convert(returnTypeName));
+    DataType* dtype = m_design->getDataTypeArena().make(
+        nullptr, InvalidNodeId, returnTypeName, convert(returnTypeName));
     FunctionMethod* method =
         new FunctionMethod(classDef, nullptr, InvalidNodeId, functionName,
                            dtype, false, false, false, false, false, false);
@@ -246,9 +247,15 @@ void Builtin::addBuiltinTypes() {
   }
 }
 
-void Builtin::addBuiltinMacros(CompilationUnit* compUnit) {
-  PreprocessHarness ppharness;
-  ppharness.preprocess(R"(
+// The builtin macros are preprocessed once per process into a private
+// compilation unit that is never modified afterwards. Every compilation unit
+// (one per file with -fileunit) then uses its macro table as a shared base
+// layer instead of running the preprocessor again.
+static const CompilationUnit* getBuiltinMacros() {
+  static const CompilationUnit* const builtinUnit = []() {
+    CompilationUnit* unit = new CompilationUnit(false);
+    PreprocessHarness ppharness;
+    ppharness.preprocess(R"(
 `define SV_COV_START 0
 `define SV_COV_STOP 1
 `define SV_COV_RESET 2
@@ -265,7 +272,14 @@ void Builtin::addBuiltinMacros(CompilationUnit* compUnit) {
 `define SV_COV_OK 1
 `define SV_COV_PARTIAL 2
   )",
-                       compUnit);
+                         unit);
+    return unit;
+  }();
+  return builtinUnit;
+}
+
+void Builtin::addBuiltinMacros(CompilationUnit* compUnit) {
+  compUnit->setBaseMacros(&getBuiltinMacros()->getMacros());
 }
 
 void Builtin::addBuiltinClasses() {
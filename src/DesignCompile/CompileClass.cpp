@@ -23,6 +23,7 @@
 
 #include <Surelog/CommandLine/CommandLineParser.h>
 #include <Surelog/Common/FileSystem.h>
+#include <Surelog/Design/Design.h>
 #include <Surelog/Design/FileContent.h>
 #include <Surelog/DesignCompile/CompileClass.h>
 #include <Surelog/DesignCompile/CompileDesign.h>
@@ -140,8 +141,8 @@ bool CompileClass::compile() {
   compile_class_parameters_(fC, nodeId);
 
   // This
-  DataType* thisdt =
-      new DataType(fC, nodeId, "this", VObjectType::slClass_declaration);
+  DataType* thisdt = m_design->getDataTypeArena().make(
+      fC, nodeId, "this", VObjectType::slClass_declaration);
   thisdt->setDefinition(m_class);
   Property* prop = new Property(thisdt, fC, nodeId, InvalidNodeId, "this",
                                 false, false, false, false, false);
@@ -254,7 +255,7 @@ bool CompileClass::compile() {
   }
 
   // Default constructor
-  DataType* returnType = new DataType();
+  DataType* returnType = m_design->getDataTypeArena().make();
   FunctionMethod* method =
       new FunctionMethod(m_class, fC, nodeId, "new", returnType, false, false,
                          false, false, false, false);
@@ -329,8 +330,8 @@ bool CompileClass::compile_class_property_(const FileContent* fC, NodeId id) {
       }
       DataType* datatype = m_class->getUsedDataType(typeName);
       if (!datatype) {
-        DataType* type =
-            new DataType(fC, node_type, typeName, fC->Type(node_type));
+        DataType* type = m_design->getDataTypeArena().make(
+            fC, node_type, typeName, fC->Type(node_type));
         m_class->insertUsedDataType(typeName, type);
         datatype = m_class->getUsedDataType(typeName);
       }
@@ -397,7 +398,7 @@ bool CompileClass::compile_class_method_(const FileContent* fC, NodeId id) {
   bool is_local = false;
   bool is_protected = false;
   bool is_pure = false;
-  DataType* returnType = new DataType();
+  DataType* returnType = m_design->getDataTypeArena().make();
   while ((func_type == VObjectType::slMethodQualifier_Virtual) ||
          (func_type == VObjectType::slMethodQualifier_ClassItem) ||
          (func_type == VObjectType::slPure_virtual_qualifier) ||
@@ -588,8 +589,8 @@ bool CompileClass::compile_class_method_(const FileContent* fC, NodeId id) {
     FunctionMethod* method = new FunctionMethod(
         m_class, fC, id, funcName, returnType, is_virtual, is_extern, is_static,
         is_local, is_protected, is_pure);
-    Variable* variable =
-        new Variable(returnType, fC, id, InvalidNodeId, funcName);
+    Variable* variable = m_design->getVariableArena().make(
+        returnType, fC, id, InvalidNodeId, funcName);
     method->addVariable(variable);
     method->compile(m_helper);
     Function* prevDef = m_class->getFunction(funcName);
@@ -49,6 +49,9 @@
 #include <Surelog/Testbench/Program.h>
 
 // UHDM
+#include <uhdm/ElaboratorListener.h>
+#include <uhdm/design.h>
+#include <uhdm/module.h>
 #include <uhdm/param_assign.h>
 #include <uhdm/vpi_visitor.h>
 
@@ -330,8 +333,8 @@ bool CompileDesign::compilation_() {
       m_compiler->getDesign()->getProgramDefinitions(), maxThreadCount);
 
   if (m_compiler->getCommandLineParser()->parseBuiltIn()) {
-    Builtin* builtin = new Builtin(this, design);
-    builtin->addBuiltinClasses();
+    Builtin builtin(this, design);
+    builtin.addBuiltinClasses();
   }
 
   // Compile classes
@@ -342,8 +345,8 @@ bool CompileDesign::compilation_() {
   collectObjects_(all_files, design, true);
 
   if (m_compiler->getCommandLineParser()->parseBuiltIn()) {
-    Builtin* builtin = new Builtin(this, design);
-    builtin->addBuiltinTypes();
+    Builtin builtin(this, design);
+    builtin.addBuiltinTypes();
   }
 
   m_compiler->getDesign()->orderPackages();
@@ -380,6 +383,42 @@ vpiHandle CompileDesign::writeUHDM(PathId fileId) {
   return h;
 }
 
+UHDM::module* CompileDesign::elaborateUhdmTop(std::string_view topName) {
+  vpiHandle designHandle = m_compiler->getUhdmDesign();
+  if (designHandle == nullptr) return nullptr;
+  UHDM::design* d = UhdmDesignFromVpiHandle(designHandle);
+  if ((d == nullptr) || (d->TopModules() == nullptr)) return nullptr;
+  UHDM::VectorOfmodule* topModules = d->TopModules();
+  UHDM::module* top = nullptr;
+  for (UHDM::module* m : *topModules) {
+    if (m->VpiName() == topName) {
+      top = m;
+      break;
+    }
+  }
+  if (top == nullptr) return nullptr;
+  // Eagerly elaborated (-elabuhdm) or not asked for
+  if (d->VpiElaborated() || !m_compiler->getCommandLineParser()->lazyElabUhdm())
+    return top;
+
+  std::lock_guard<std::mutex> guard(m_serializerMutex);
+  if (!m_elaboratedUhdmTops.emplace(topName).second) return top;
+
+  // Run the elaborator over a view of the design restricted to this top.
+  // Every run sees all the packages and classes: a fresh listener only
+  // binds package references in the scopes it has walked itself.
+  UHDM::VectorOfmodule tops(1, top);
+  d->TopModules(&tops);
+  UHDM::ElaboratorListener* listener =
+      new UHDM::ElaboratorListener(&m_serializer, false, false);
+  listener->uniquifyTypespec(false);
+  listener->listenDesigns({designHandle});
+  delete listener;
+  d->TopModules(topModules);
+  d->VpiElaborated(m_elaboratedUhdmTops.size() == topModules->size());
+  return top;
+}
+
 void decompile(ValuedComponentI* instance) {
   FileSystem* const fileSystem = FileSystem::getInstance();
   if (instance) {
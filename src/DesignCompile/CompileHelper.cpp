@@ -24,6 +24,7 @@
 #include <Surelog/CommandLine/CommandLineParser.h>
 #include <Surelog/Common/FileSystem.h>
 #include <Surelog/Design/DataType.h>
+#include <Surelog/Design/Design.h>
 #include <Surelog/Design/DummyType.h>
 #include <Surelog/Design/Enum.h>
 #include <Surelog/Design/FileContent.h>
@@ -179,7 +180,7 @@ bool CompileHelper::importPackage(DesignComponent* scope, Design* design,
         if (param.first != object_name) continue;
       }
       Parameter* orig = param.second;
-      Parameter* clone = new Parameter(*orig);
+      Parameter* clone = design->getParameterArena().make(*orig);
       clone->setImportedPackage(pack_name);
       scope->insertParameter(clone);
       UHDM::any* p = orig->getUhdmParam();
@@ -593,7 +594,9 @@ const DataType* CompileHelper::compileTypeDef(DesignComponent* scope,
 
   VObjectType base_type = fC->Type(data_type);
 
-  DataType* type = new DataType(fC, data_type, name, base_type);
+  Design* const design = compileDesign->getCompiler()->getDesign();
+  DataType* type =
+      design->getDataTypeArena().make(fC, data_type, name, base_type);
   if (scope) scope->insertDataType(name, type);
 
   // Enum or Struct or Union
@@ -755,8 +758,8 @@ const DataType* CompileHelper::compileTypeDef(DesignComponent* scope,
       the_enum->addValue(enumName, fC->Line(enumNameId), value);
       val++;
       if (scope) scope->setValue(enumName, value, m_exprBuilder);
-      Variable* variable =
-          new Variable(type, fC, enumValueId, InvalidNodeId, enumName);
+      Variable* variable = design->getVariableArena().make(
+          type, fC, enumValueId, InvalidNodeId, enumName);
       if (scope) scope->addVariable(variable);
 
       enum_const* econst = s.MakeEnum_const();
@@ -1388,8 +1391,8 @@ VObjectType getSignalType(const FileContent* fC, NodeId net_port_type,
   return signal_type;
 }
 
-void setDirectionAndType(DesignComponent* component, const FileContent* fC,
-                         NodeId signal, VObjectType type,
+void setDirectionAndType(Design* design, DesignComponent* component,
+                         const FileContent* fC, NodeId signal, VObjectType type,
                          VObjectType signal_type, NodeId packed_dimension,
                          bool is_signed, bool is_var, NodeId nodeType,
                          UHDM::VectorOfattribute* attributes) {
@@ -1434,7 +1437,7 @@ void setDirectionAndType(DesignComponent* component, const FileContent* fC,
         }
       }
       if (found == false) {
-        Signal* sig = new Signal(
+        Signal* sig = design->getSignalArena().make(
             fC, signal, signal_type, packed_dimension, dir_type, nodeType,
             /* unpackedDimension */ InvalidNodeId, is_signed);
         sig->setStatic();
@@ -1480,6 +1483,7 @@ bool CompileHelper::compilePortDeclaration(DesignComponent* component,
                                            CompileDesign* compileDesign,
                                            VObjectType& port_direction,
                                            bool hasNonNullPort) {
+  Design* const design = compileDesign->getCompiler()->getDesign();
   VObjectType type = fC->Type(id);
   switch (type) {
     case VObjectType::slPort: {
@@ -1505,15 +1509,15 @@ bool CompileHelper::compilePortDeclaration(DesignComponent* component,
           NodeId if_name = fC->Sibling(if_type);
           if (if_name) {
             NodeId if_name_s = fC->Child(if_name);
-            Signal* signal =
-                new Signal(fC, if_name_s, if_type_name_s, VObjectType::slNoType,
-                           InvalidNodeId, false);
+            Signal* signal = design->getSignalArena().make(
+                fC, if_name_s, if_type_name_s, VObjectType::slNoType,
+                InvalidNodeId, false);
             signal->setStatic();
             component->getPorts().push_back(signal);
           } else {
-            Signal* signal = new Signal(fC, if_type_name_s,
-                                        VObjectType::slData_type_or_implicit,
-                                        port_direction, InvalidNodeId, false);
+            Signal* signal = design->getSignalArena().make(
+                fC, if_type_name_s, VObjectType::slData_type_or_implicit,
+                port_direction, InvalidNodeId, false);
             signal->setStatic();
             component->getPorts().push_back(signal);
           }
@@ -1521,9 +1525,9 @@ bool CompileHelper::compilePortDeclaration(DesignComponent* component,
       } else {
         if (hasNonNullPort) {
           // Null port
-          Signal* signal =
-              new Signal(fC, id, VObjectType::slNoType, VObjectType::slNoType,
-                         InvalidNodeId, false);
+          Signal* signal = design->getSignalArena().make(
+              fC, id, VObjectType::slNoType, VObjectType::slNoType,
+              InvalidNodeId, false);
           signal->setStatic();
           component->getPorts().push_back(signal);
         }
@@ -1576,9 +1580,9 @@ bool CompileHelper::compilePortDeclaration(DesignComponent* component,
               interface_identifier = fC->Sibling(interface_identifier);
               unpackedDimension = Unpacked_dimension;
             }
-            Signal* signal =
-                new Signal(fC, identifier, interfIdName, VObjectType::slNoType,
-                           unpackedDimension, false);
+            Signal* signal = design->getSignalArena().make(
+                fC, identifier, interfIdName, VObjectType::slNoType,
+                unpackedDimension, false);
             signal->setStatic();
             component->getSignals().push_back(signal);
             interface_identifier = fC->Sibling(interface_identifier);
@@ -1624,9 +1628,9 @@ bool CompileHelper::compilePortDeclaration(DesignComponent* component,
           if (!nodeType) {
             nodeType = fC->Child(net_port_type);
           }
-          setDirectionAndType(component, fC, signal, subType, signal_type,
-                              Packed_dimension, is_signed, is_var, nodeType,
-                              attributes);
+          setDirectionAndType(design, component, fC, signal, subType,
+                              signal_type, Packed_dimension, is_signed, is_var,
+                              nodeType, attributes);
           break;
         }
         default:
@@ -1642,7 +1646,9 @@ bool CompileHelper::compilePortDeclaration(DesignComponent* component,
 
 bool CompileHelper::compileAnsiPortDeclaration(DesignComponent* component,
                                                const FileContent* fC, NodeId id,
+                                               CompileDesign* compileDesign,
                                                VObjectType& port_direction) {
+  Design* const design = compileDesign->getCompiler()->getDesign();
   /*
   n<mem_if> u<3> t<StringConst> p<4> l<11>
   n<> u<4> t<Data_type> p<5> c<3> l<11>
@@ -1727,16 +1733,16 @@ bool CompileHelper::compileAnsiPortDeclaration(DesignComponent* component,
     if (!nodeType) {
       nodeType = NetType;
     }
-    Signal* p = new Signal(fC, identifier, signal_type, packedDimension,
-                           port_direction, specParamId ? specParamId : nodeType,
-                           unpackedDimension, is_signed);
+    Signal* p = design->getSignalArena().make(
+        fC, identifier, signal_type, packedDimension, port_direction,
+        specParamId ? specParamId : nodeType, unpackedDimension, is_signed);
     if (is_var) p->setVar();
     p->setDefaultValue(defaultValue);
     p->setStatic();
     component->getPorts().push_back(p);
-    Signal* s = new Signal(fC, identifier, signal_type, packedDimension,
-                           port_direction, specParamId ? specParamId : nodeType,
-                           unpackedDimension, is_signed);
+    Signal* s = design->getSignalArena().make(
+        fC, identifier, signal_type, packedDimension, port_direction,
+        specParamId ? specParamId : nodeType, unpackedDimension, is_signed);
     if (is_var) s->setVar();
     s->setStatic();
     component->getSignals().push_back(s);
@@ -1754,8 +1760,9 @@ bool CompileHelper::compileAnsiPortDeclaration(DesignComponent* component,
     n<sif2> u<14> t<StringConst> p<15> l<11>
     n<> u<15> t<Ansi_port_declaration> p<16> c<13> l<11>
     */
-    Signal* s = new Signal(fC, port_name, interface_name, VObjectType::slNoType,
-                           unpacked_dimension, false);
+    Signal* s = design->getSignalArena().make(fC, port_name, interface_name,
+                                              VObjectType::slNoType,
+                                              unpacked_dimension, false);
     s->setStatic();
     s->setTypespecId(interface_name);
     component->getPorts().push_back(s);
@@ -1769,16 +1776,17 @@ bool CompileHelper::compileAnsiPortDeclaration(DesignComponent* component,
         unpackedDimension = InvalidNodeId;
       if (fC->Type(if_type_name_s) == VObjectType::slIntVec_TypeReg ||
           fC->Type(if_type_name_s) == VObjectType::slIntVec_TypeLogic) {
-        Signal* signal =
-            new Signal(fC, identifier, fC->Type(if_type_name_s),
-                       VObjectType::slNoType, unpackedDimension, false);
+        Signal* signal = design->getSignalArena().make(
+            fC, identifier, fC->Type(if_type_name_s), VObjectType::slNoType,
+            unpackedDimension, false);
         signal->setStatic();
         component->getPorts().push_back(signal);
         // DO NOT create signals for interfaces:
         // component->getSignals().push_back(signal);
       } else {
-        Signal* s = new Signal(fC, identifier, if_type_name_s,
-                               VObjectType::slNoType, unpackedDimension, false);
+        Signal* s = design->getSignalArena().make(
+            fC, identifier, if_type_name_s, VObjectType::slNoType,
+            unpackedDimension, false);
         s->setStatic();
         s->setTypespecId(if_type_name_s);
         component->getPorts().push_back(s);
@@ -1802,28 +1810,30 @@ bool CompileHelper::compileAnsiPortDeclaration(DesignComponent* component,
         unpacked = last->getUnpackedDimension();
       }
       if (specParamId) {
-        Signal* signal =
-            new Signal(fC, identifier, dataType, packed, port_direction,
-                       specParamId, unpacked, is_signed);
+        Signal* signal = design->getSignalArena().make(
+            fC, identifier, dataType, packed, port_direction, specParamId,
+            unpacked, is_signed);
         signal->setStatic();
         component->getPorts().push_back(signal);
-        signal = new Signal(fC, identifier, dataType, packed, port_direction,
-                            specParamId, unpacked, is_signed);
+        signal = design->getSignalArena().make(fC, identifier, dataType, packed,
+                                               port_direction, specParamId,
+                                               unpacked, is_signed);
         signal->setStatic();
         component->getSignals().push_back(signal);
       } else {
         if (fC->Type(net_port_header) == VObjectType::slInterface_port_header) {
           dataType = VObjectType::slInterface_port_header;
         }
-        Signal* signal = new Signal(fC, identifier, dataType, port_direction,
-                                    packed, is_signed);
+        Signal* signal = design->getSignalArena().make(
+            fC, identifier, dataType, port_direction, packed, is_signed);
         if (fC->Type(net_port_header) == VObjectType::slInterface_port_header) {
           signal->setTypespecId(identifier);
         }
         signal->setStatic();
         component->getPorts().push_back(signal);
-        signal = new Signal(fC, identifier, dataType, port_direction, packed,
-                            is_signed);
+        signal = design->getSignalArena().make(fC, identifier, dataType,
+                                               port_direction, packed,
+                                               is_signed);
         if (fC->Type(net_port_header) == VObjectType::slInterface_port_header) {
           signal->setTypespecId(identifier);
         }
@@ -1839,6 +1849,7 @@ bool CompileHelper::compileNetDeclaration(DesignComponent* component,
                                           const FileContent* fC, NodeId id,
                                           bool interface,
                                           CompileDesign* compileDesign) {
+  Design* const design = compileDesign->getCompiler()->getDesign();
   /*
  n<> u<17> t<NetType_Wire> p<18> l<27>
  n<> u<18> t<NetTypeOrTrireg_Net> p<22> c<17> s<21> l<27>
@@ -1910,17 +1921,17 @@ bool CompileHelper::compileNetDeclaration(DesignComponent* component,
     }
 
     if (nettype == VObjectType::slStringConst) {
-      Signal* sig = new Signal(fC, signal, InvalidNodeId, subnettype,
-                               Unpacked_dimension, false);
+      Signal* sig = design->getSignalArena().make(
+          fC, signal, InvalidNodeId, subnettype, Unpacked_dimension, false);
       if (portRef) portRef->setLowConn(sig);
       sig->setDelay(delay);
       sig->setStatic();
       sig->setTypespecId(NetType);
       component->getSignals().push_back(sig);
     } else {
-      Signal* sig =
-          new Signal(fC, signal, nettype, Packed_dimension,
-                     VObjectType::slNoType, NetType, Unpacked_dimension, false);
+      Signal* sig = design->getSignalArena().make(
+          fC, signal, nettype, Packed_dimension, VObjectType::slNoType, NetType,
+          Unpacked_dimension, false);
       if (portRef) portRef->setLowConn(sig);
       sig->setDelay(delay);
       sig->setStatic();
@@ -2098,9 +2109,10 @@ bool CompileHelper::compileDataDeclaration(
         Signal* sig = nullptr;
         VObjectType sigType = fC->Type(intVec_TypeReg);
 
-        sig = new Signal(fC, signal, sigType, packedDimension,
-                         VObjectType::slNoType, intVec_TypeReg,
-                         unpackedDimension, false);
+        Design* const design = compileDesign->getCompiler()->getDesign();
+        sig = design->getSignalArena().make(
+            fC, signal, sigType, packedDimension, VObjectType::slNoType,
+            intVec_TypeReg, unpackedDimension, false);
 
         if (is_const) sig->setConst();
         if (var_type) sig->setVar();
@@ -2591,6 +2603,7 @@ bool CompileHelper::compileParameterDeclaration(
     DesignComponent* component, const FileContent* fC, NodeId nodeId,
     CompileDesign* compileDesign, bool localParam, ValuedComponentI* instance,
     bool port_param, bool reduce, bool muteErrors) {
+  Design* const design = compileDesign->getCompiler()->getDesign();
   UHDM::Serializer& s = compileDesign->getSerializer();
   compileDesign->lockSerializer();
   std::vector<UHDM::any*>* parameters = component->getParameters();
@@ -2626,8 +2639,8 @@ bool CompileHelper::compileParameterDeclaration(
         p->VpiLocalParam(true);
       }
       parameters->push_back(p);
-      Parameter* param = new Parameter(fC, typeNameId, fC->SymName(typeNameId),
-                                       ntype, port_param);
+      Parameter* param = design->getParameterArena().make(
+          fC, typeNameId, fC->SymName(typeNameId), ntype, port_param);
       param->setTypeParam();
       param->setUhdmParam(p);
       component->insertParameter(param);
@@ -2654,8 +2667,9 @@ bool CompileHelper::compileParameterDeclaration(
         p->VpiLocalParam(true);
       }
       parameters->push_back(p);
-      Parameter* param = new Parameter(fC, Identifier, fC->SymName(Identifier),
-                                       Constant_param_expression, port_param);
+      Parameter* param = design->getParameterArena().make(
+          fC, Identifier, fC->SymName(Identifier), Constant_param_expression,
+          port_param);
       param->setTypeParam();
       param->setUhdmParam(p);
       component->insertParameter(param);
@@ -2705,9 +2719,9 @@ bool CompileHelper::compileParameterDeclaration(
       NodeId value = fC->Sibling(name);
 
       UHDM::parameter* param = s.MakeParameter();
-      Parameter* p =
-          new Parameter(fC, name, fC->SymName(name),
-                        fC->Child(Data_type_or_implicit), port_param);
+      Parameter* p = design->getParameterArena().make(
+          fC, name, fC->SymName(name), fC->Child(Data_type_or_implicit),
+          port_param);
 
       // Unpacked dimensions
       if (fC->Type(value) == VObjectType::slUnpacked_dimension) {
@@ -111,17 +111,18 @@ bool CompileModule::compile() {
   }
   std::set<std::string, std::less<>>& blackboxInstances =
       clp->getBlackBoxInstances();
-  std::string instanceName;
-  if (m_instance) {
+  if (m_instance && !blackboxInstances.empty()) {
     if (ModuleInstance* inst =
             valuedcomponenti_cast<ModuleInstance*>(m_instance)) {
-      instanceName = inst->getFullPathName();
+      for (const std::string& instanceName : blackboxInstances) {
+        if (inst->matchesFullPathName(instanceName)) {
+          errType = ErrorDefinition::COMP_SKIPPING_BLACKBOX_INSTANCE;
+          skipModule = true;
+          break;
+        }
+      }
     }
   }
-  if (blackboxInstances.find(instanceName) != blackboxInstances.end()) {
-    errType = ErrorDefinition::COMP_SKIPPING_BLACKBOX_INSTANCE;
-    skipModule = true;
-  }
   if (blackboxInstances.find(modName) != blackboxInstances.end()) {
     errType = ErrorDefinition::COMP_SKIPPING_BLACKBOX_INSTANCE;
     skipModule = true;
@@ -571,7 +572,8 @@ bool CompileModule::collectModuleObjects_(CollectType collectType) {
         }
         case VObjectType::slAnsi_port_declaration: {
           if (collectType != CollectType::DEFINITION) break;
-          m_helper.compileAnsiPortDeclaration(m_module, fC, id, port_direction);
+          m_helper.compileAnsiPortDeclaration(m_module, fC, id, m_compileDesign,
+                                              port_direction);
           m_attributes = nullptr;
           break;
         }
@@ -945,7 +947,8 @@ bool CompileModule::collectInterfaceObjects_(CollectType collectType) {
         }
         case VObjectType::slAnsi_port_declaration: {
           if (collectType != CollectType::DEFINITION) break;
-          m_helper.compileAnsiPortDeclaration(m_module, fC, id, port_direction);
+          m_helper.compileAnsiPortDeclaration(m_module, fC, id, m_compileDesign,
+                                              port_direction);
           m_attributes = nullptr;
           break;
         }
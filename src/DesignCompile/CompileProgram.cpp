@@ -145,7 +145,8 @@ bool CompileProgram::collectObjects_(CollectType collectType) {
       }
       case VObjectType::slAnsi_port_declaration: {
         if (collectType != CollectType::DEFINITION) break;
-        m_helper.compileAnsiPortDeclaration(m_program, fC, id, port_direction);
+        m_helper.compileAnsiPortDeclaration(m_program, fC, id, m_compileDesign,
+                                            port_direction);
         break;
       }
       case VObjectType::slPort: {
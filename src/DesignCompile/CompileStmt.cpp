@@ -2402,11 +2402,12 @@ Function* CompileHelper::compileFunctionPrototype(
     func->Io_decls(results.first);
   }
 
-  DataType* returnType = new DataType();
+  Design* const design = compileDesign->getCompiler()->getDesign();
+  DataType* returnType = design->getDataTypeArena().make();
   returnType->init(fC, type, typeName, fC->Type(type));
   Function* result = new Function(scope, fC, id, funcName, returnType);
-  Variable* variable =
-      new Variable(returnType, fC, id, InvalidNodeId, funcName);
+  Variable* variable = design->getVariableArena().make(
+      returnType, fC, id, InvalidNodeId, funcName);
   result->addVariable(variable);
   result->compile(*this);
   return result;
@@ -24,6 +24,7 @@
 #include <Surelog/CommandLine/CommandLineParser.h>
 #include <Surelog/Common/FileSystem.h>
 #include <Surelog/Design/DataType.h>
+#include <Surelog/Design/Design.h>
 #include <Surelog/Design/DummyType.h>
 #include <Surelog/Design/Enum.h>
 #include <Surelog/Design/FileContent.h>
@@ -1144,7 +1145,8 @@ UHDM::typespec* CompileHelper::compileTypespec(
         val++;
         if (component) component->setValue(enumName, value, m_exprBuilder);
         Variable* variable =
-            new Variable(nullptr, fC, enumValueId, InvalidNodeId, enumName);
+            compileDesign->getCompiler()->getDesign()->getVariableArena().make(
+                nullptr, fC, enumValueId, InvalidNodeId, enumName);
         if (component) component->addVariable(variable);
 
         enum_const* econst = s.MakeEnum_const();
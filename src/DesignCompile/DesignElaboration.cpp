@@ -26,6 +26,7 @@
 #include <Surelog/Config/ConfigSet.h>
 #include <Surelog/Design/BindStmt.h>
 #include <Surelog/Design/DefParam.h>
+#include <Surelog/Design/Design.h>
 #include <Surelog/Design/DesignElement.h>
 #include <Surelog/Design/FileContent.h>
 #include <Surelog/Design/ModuleDefinition.h>
@@ -532,7 +533,9 @@ bool DesignElaboration::elaborateModule_(const std::string& moduleName,
   Config* config = getInstConfig(moduleName);
   if (config == nullptr) config = getCellConfig(moduleName);
   Design* design = m_compileDesign->getCompiler()->getDesign();
-  if (!m_moduleInstFactory) m_moduleInstFactory = new ModuleInstanceFactory();
+  if (!m_moduleInstFactory) {
+    m_moduleInstFactory = new ModuleInstanceFactory(m_symbols);
+  }
   for (const auto& nameId : nameIds) {
     if ((fC->Type(nameId.second) == VObjectType::slModule_declaration) &&
         (moduleName == (libName + "@" + nameId.first))) {
@@ -618,7 +621,8 @@ ModuleInstance* DesignElaboration::createBindInstance_(
   bool instanceMatch = true;
   if (targetInstId) {
     const std::string& targetInstName = fC->SymName(targetInstId);
-    instanceMatch = (targetInstName == parent->getInstanceName());
+    instanceMatch =
+        (m_symbols->getId(targetInstName) == parent->getInstanceNameId());
   }
   DesignComponent* targetDef = nullptr;
   if (def && (def->getName() == targetName) && instanceMatch) {
@@ -718,10 +722,6 @@ void DesignElaboration::elaborateInstance_(
   }
   std::set<std::string, std::less<>>& blackboxInstances =
       clp->getBlackBoxInstances();
-  std::string instanceName;
-  if (parent) {
-    instanceName = parent->getFullPathName();
-  }
   if (blackboxInstances.find(modName) != blackboxInstances.end()) {
     SymbolTable* st =
         m_compileDesign->getCompiler()->getErrorContainer()->getSymbolTable();
@@ -732,15 +732,17 @@ void DesignElaboration::elaborateInstance_(
                                                                   false);
     return;
   }
-  if (blackboxInstances.find(instanceName) != blackboxInstances.end()) {
-    SymbolTable* st =
-        m_compileDesign->getCompiler()->getErrorContainer()->getSymbolTable();
-    Location loc(fC->getFileId(), fC->Line(nodeId), fC->Column(nodeId),
-                 st->registerSymbol(instanceName));
-    Error err(ErrorDefinition::ELAB_SKIPPING_BLACKBOX_INSTANCE, loc);
-    m_compileDesign->getCompiler()->getErrorContainer()->addError(err, false,
-                                                                  false);
-    return;
+  for (const std::string& instanceName : blackboxInstances) {
+    if (parent && parent->matchesFullPathName(instanceName)) {
+      SymbolTable* st =
+          m_compileDesign->getCompiler()->getErrorContainer()->getSymbolTable();
+      Location loc(fC->getFileId(), fC->Line(nodeId), fC->Column(nodeId),
+                   st->registerSymbol(instanceName));
+      Error err(ErrorDefinition::ELAB_SKIPPING_BLACKBOX_INSTANCE, loc);
+      m_compileDesign->getCompiler()->getErrorContainer()->addError(err, false,
+                                                                    false);
+      return;
+    }
   }
 
   std::vector<ModuleInstance*>& allSubInstances = parent->getAllSubInstances();
@@ -806,8 +808,7 @@ void DesignElaboration::elaborateInstance_(
   // Apply DefParams
   Design* design = m_compileDesign->getCompiler()->getDesign();
   for (const auto& name : params) {
-    DefParam* defparam =
-        design->getDefParam(parent->getFullPathName() + "." + name);
+    DefParam* defparam = design->getDefParam(parent, name);
     if (defparam) {
       Value* value = defparam->getValue();
       if (value) {
@@ -2040,8 +2041,8 @@ void DesignElaboration::collectParams_(std::vector<std::string>& params,
             NodeId param_expression = parentFile->Sibling(child);
             NodeId data_type = parentFile->Child(param_expression);
             NodeId type = parentFile->Child(data_type);
-            Parameter* param =
-                new Parameter(parentFile, expr, pname, type, true);
+            Parameter* param = design->getParameterArena().make(
+                parentFile, expr, pname, type, true);
             instance->getTypeParams().push_back(param);
             // Set the invalid value as a marker for netlist elaboration
             instance->setValue(name, value, m_exprBuilder,
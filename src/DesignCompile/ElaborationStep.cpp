@@ -24,6 +24,7 @@
 #include <Surelog/CommandLine/CommandLineParser.h>
 #include <Surelog/Common/FileSystem.h>
 #include <Surelog/Design/DataType.h>
+#include <Surelog/Design/Design.h>
 #include <Surelog/Design/DummyType.h>
 #include <Surelog/Design/Enum.h>
 #include <Surelog/Design/FileContent.h>
@@ -539,16 +540,18 @@ const DataType* ElaborationStep::bindDataType_(
   std::string class_in_lib = libName + "@" + type_name;
   ClassNameClassDefinitionMultiMap::iterator itr1 = classes.end();
 
+  TypedArena<DataType>& dataTypes = design->getDataTypeArena();
   if (type_name == "signed") {
-    return new DataType(fC, id, type_name, VObjectType::slSigning_Signed);
+    return dataTypes.make(fC, id, type_name, VObjectType::slSigning_Signed);
   } else if (type_name == "unsigned") {
-    return new DataType(fC, id, type_name, VObjectType::slSigning_Unsigned);
+    return dataTypes.make(fC, id, type_name, VObjectType::slSigning_Unsigned);
   } else if (type_name == "logic") {
-    return new DataType(fC, id, type_name, VObjectType::slIntVec_TypeLogic);
+    return dataTypes.make(fC, id, type_name, VObjectType::slIntVec_TypeLogic);
   } else if (type_name == "bit") {
-    return new DataType(fC, id, type_name, VObjectType::slIntVec_TypeBit);
+    return dataTypes.make(fC, id, type_name, VObjectType::slIntVec_TypeBit);
   } else if (type_name == "byte") {
-    return new DataType(fC, id, type_name, VObjectType::slIntegerAtomType_Byte);
+    return dataTypes.make(fC, id, type_name,
+                          VObjectType::slIntegerAtomType_Byte);
   }
 
   const DataType* result = nullptr;
@@ -868,10 +871,10 @@ Variable* ElaborationStep::locateStaticVariable_(
             package->getClassDefinition(var_chain[1]);
         if (classDefinition) {
           if (var_chain.size() == 2) {
-            result =
-                new Variable(classDefinition, classDefinition->getFileContent(),
-                             classDefinition->getNodeId(), InvalidNodeId,
-                             classDefinition->getName());
+            result = design->getVariableArena().make(
+                classDefinition, classDefinition->getFileContent(),
+                classDefinition->getNodeId(), InvalidNodeId,
+                classDefinition->getName());
           }
           if (var_chain.size() == 3) {
             std::vector<std::string> tmp;
@@ -897,10 +900,10 @@ Variable* ElaborationStep::locateStaticVariable_(
       }
       if (classDefinition) {
         if (var_chain.size() == 1)
-          result =
-              new Variable(classDefinition, classDefinition->getFileContent(),
-                           classDefinition->getNodeId(), InvalidNodeId,
-                           classDefinition->getName());
+          result = design->getVariableArena().make(
+              classDefinition, classDefinition->getFileContent(),
+              classDefinition->getNodeId(), InvalidNodeId,
+              classDefinition->getName());
         if (var_chain.size() == 2) {
           std::vector<std::string> tmp;
           tmp.push_back(var_chain[1]);
@@ -909,9 +912,9 @@ Variable* ElaborationStep::locateStaticVariable_(
               bindDataType_(var_chain[1], fC, id, classDefinition,
                             ErrorDefinition::NO_ERROR_MESSAGE);
           if (dtype) {
-            result =
-                new Variable(dtype, dtype->getFileContent(), dtype->getNodeId(),
-                             InvalidNodeId, dtype->getName());
+            result = design->getVariableArena().make(
+                dtype, dtype->getFileContent(), dtype->getNodeId(),
+                InvalidNodeId, dtype->getName());
           } else
             result =
                 locateVariable_(tmp, fC, id, scope, classDefinition, errtype);
@@ -924,9 +927,9 @@ Variable* ElaborationStep::locateStaticVariable_(
       const DataType* dtype =
           bindDataType_(var_chain[0], fC, id, parentComponent, errtype);
       if (dtype) {
-        result =
-            new Variable(dtype, dtype->getFileContent(), dtype->getNodeId(),
-                         InvalidNodeId, dtype->getName());
+        result = design->getVariableArena().make(
+            dtype, dtype->getFileContent(), dtype->getNodeId(), InvalidNodeId,
+            dtype->getName());
       }
     }
   }
@@ -1175,8 +1178,8 @@ bool ElaborationStep::bindPortType_(Signal* signal, const FileContent* fC,
         def = design->getComponentDefinition(libName + "@" + baseName);
         ClassDefinition* c = valuedcomponenti_cast<ClassDefinition*>(def);
         if (c) {
-          Variable* var = new Variable(c, fC, signal->getNodeId(),
-                                       InvalidNodeId, signal->getName());
+          Variable* var = design->getVariableArena().make(
+              c, fC, signal->getNodeId(), InvalidNodeId, signal->getName());
           parentComponent->addVariable(var);
           return false;
         } else {
@@ -14,13 +14,16 @@
  limitations under the License.
 */
 
+#include <Surelog/Design/DefParam.h>
 #include <Surelog/Design/Design.h>
 #include <Surelog/Design/FileContent.h>
 #include <Surelog/Design/ModuleInstance.h>
 #include <Surelog/DesignCompile/CompileDesign.h>
 #include <Surelog/DesignCompile/CompileHelper.h>
 #include <Surelog/DesignCompile/ElaboratorHarness.h>
+#include <Surelog/ErrorReporting/ErrorContainer.h>
 #include <Surelog/SourceCompile/Compiler.h>
+#include <Surelog/SourceCompile/SymbolTable.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -1209,5 +1212,80 @@ endmodule
   }
 }
 
+TEST(Elaboration, DefParamOnNestedInstance) {
+  CompileHelper helper;
+  ElaboratorHarness eharness;
+
+  // Preprocess, Parse, Compile, Elaborate
+  Design* design;
+  FileContent* fC;
+  CompileDesign* compileDesign;
+  std::tie(design, fC, compileDesign) = eharness.elaborate(R"(
+module leaf;
+  parameter P = 1;
+endmodule
+
+module mid;
+  leaf u_leaf();
+endmodule
+
+module top;
+  mid u_mid();
+  defparam u_mid.u_leaf.P = 5;
+endmodule
+  )");
+  auto insts = design->getTopLevelModuleInstances();
+  ASSERT_EQ(insts.size(), 1u);
+  ModuleInstance* top = insts.at(0);
+  ModuleInstance* mid = top->getChildByName("u_mid");
+  ASSERT_NE(mid, nullptr);
+  ModuleInstance* leaf = mid->getChildByName("u_leaf");
+  ASSERT_NE(leaf, nullptr);
+
+  const std::string path = top->getFullPathName() + ".u_mid.u_leaf";
+  EXPECT_EQ(leaf->getFullPathName(), path);
+  // Built once, later calls return the same string
+  EXPECT_EQ(&leaf->getFullPathName(), &leaf->getFullPathName());
+  EXPECT_TRUE(leaf->matchesFullPathName(path));
+  EXPECT_FALSE(leaf->matchesFullPathName(top->getFullPathName() + ".u_leaf"));
+  EXPECT_FALSE(mid->matchesFullPathName(path));
+
+  DefParam* defparam = design->getDefParam(leaf, "P");
+  ASSERT_NE(defparam, nullptr);
+  EXPECT_TRUE(defparam->isUsed());
+  EXPECT_EQ(design->getDefParam(path + ".P"), defparam);
+  EXPECT_EQ(design->getDefParam(mid, "P"), nullptr);
+}
+
+TEST(Elaboration, UnmatchedDefParamsInNameOrder) {
+  CompileHelper helper;
+  ElaboratorHarness eharness;
+
+  // Preprocess, Parse, Compile, Elaborate
+  Design* design;
+  FileContent* fC;
+  CompileDesign* compileDesign;
+  std::tie(design, fC, compileDesign) = eharness.elaborate(R"(
+module mid;
+  parameter P = 1;
+endmodule
+
+module top;
+  mid u_mid();
+  defparam u_mid.zz = 5;
+  defparam u_mid.aa = 6;
+endmodule
+  )");
+  ErrorContainer* errors = compileDesign->getCompiler()->getErrorContainer();
+  std::vector<std::string> unmatched;
+  for (const Error& error : errors->getErrors()) {
+    if (error.getType() != ErrorDefinition::ELAB_UNMATCHED_DEFPARAM) continue;
+    unmatched.emplace_back(errors->getSymbolTable()->getSymbol(
+        error.getLocations().front().m_object));
+  }
+  ASSERT_EQ(unmatched.size(), 2u);
+  EXPECT_LT(unmatched[0], unmatched[1]);
+  EXPECT_NE(unmatched[0].find("aa"), std::string::npos);
+}
 }  // namespace
 }  // namespace SURELOG
@@ -1225,7 +1225,7 @@ bool NetlistElaboration::high_conn_(ModuleInstance* instance) {
 
               ModuleInstance* interfaceInstance =
                   new ModuleInstance(orig_interf, fC, sigId, instance, sigName,
-                                     orig_interf->getName());
+                                     orig_interf->getName(), m_symbols);
               Netlist* netlistInterf = new Netlist(interfaceInstance);
               interfaceInstance->setNetlist(netlistInterf);
 
@@ -2249,7 +2249,7 @@ bool NetlistElaboration::elab_ports_nets_(
                 sigName += "[" + std::to_string(index) + "]";
                 ModuleInstance* interfaceInstance = new ModuleInstance(
                     orig_interf, sig->getFileContent(), sig->getNodeId(),
-                    instance, sigName, orig_interf->getName());
+                    instance, sigName, orig_interf->getName(), m_symbols);
                 Netlist* netlistInterf = new Netlist(interfaceInstance);
                 interfaceInstance->setNetlist(netlistInterf);
                 if (interfaceRefInstance) {
@@ -2272,7 +2272,7 @@ bool NetlistElaboration::elab_ports_nets_(
 
               ModuleInstance* interfaceInstance = new ModuleInstance(
                   orig_interf, sig->getFileContent(), sig->getNodeId(),
-                  instance, signame, orig_interf->getName());
+                  instance, signame, orig_interf->getName(), m_symbols);
               Netlist* netlistInterf = new Netlist(interfaceInstance);
               interfaceInstance->setNetlist(netlistInterf);
               if (interfaceRefInstance) {
@@ -2304,7 +2304,7 @@ bool NetlistElaboration::elab_ports_nets_(
           if (itr == netlist->getInstanceMap().end()) {
             ModuleInstance* interfaceInstance = new ModuleInstance(
                 orig_interf, sig->getFileContent(), sig->getNodeId(), instance,
-                signame, orig_interf->getName());
+                signame, orig_interf->getName(), m_symbols);
             Netlist* netlistInterf = new Netlist(interfaceInstance);
             interfaceInstance->setNetlist(netlistInterf);
 
@@ -2523,11 +2523,10 @@ any* NetlistElaboration::bind_net_(ModuleInstance* instance,
     if (itr != symbols.end()) {
       return (*itr).second;
     } else {
-      std::string basename = name;
-      std::string subname;
-      if (basename.find('.') != std::string::npos) {
-        subname = basename;
-        subname = StringUtils::ltrim_until(subname, '.');
+      std::string_view basename = name;
+      std::string_view subname;
+      if (basename.find('.') != std::string_view::npos) {
+        subname = StringUtils::ltrim_until(basename, '.');
         basename = StringUtils::rtrim_until(basename, '.');
       }
       itr = symbols.find(basename);
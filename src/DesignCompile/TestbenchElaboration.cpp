@@ -238,7 +238,7 @@ bool TestbenchElaboration::bindBaseClasses_() {
       class_def.second = bdef;
       if (class_def.second) {
         // Super
-        DataType* thisdt = new DataType(
+        DataType* thisdt = design->getDataTypeArena().make(
             class_def.second->getFileContent(), class_def.second->getNodeId(),
             class_def.second->getName(), VObjectType::slClass_declaration);
         thisdt->setDefinition(class_def.second);
@@ -269,7 +269,7 @@ bool TestbenchElaboration::bindBaseClasses_() {
         class_def.second = datatype_cast<const Parameter*>(the_def);
         if (class_def.second) {
           // Super
-          DataType* thisdt = new DataType(
+          DataType* thisdt = design->getDataTypeArena().make(
               class_def.second->getFileContent(), class_def.second->getNodeId(),
               class_def.second->getName(), VObjectType::slClass_declaration);
           thisdt->setDefinition(class_def.second);
@@ -555,10 +555,13 @@ bool TestbenchElaboration::bindForLoop_(ClassDefinition* classDefinition,
   const FileContent* sfC = st->getFileContent();
   NodeId fid = st->getNodeId();
   VObjectType itr_type = st->getIteratorType();
-  DataType* itrDataType = new DataType(sfC, fid, "integer", itr_type);
+  Design* const design = m_compileDesign->getCompiler()->getDesign();
+  DataType* itrDataType =
+      design->getDataTypeArena().make(sfC, fid, "integer", itr_type);
   for (const auto& itrId : st->getIteratorIds()) {
-    Variable* var = new Variable(itrDataType, sfC, itrId.first, InvalidNodeId,
-                                 sfC->SymName(itrId.first));
+    Variable* var = design->getVariableArena().make(
+        itrDataType, sfC, itrId.first, InvalidNodeId,
+        sfC->SymName(itrId.first));
     st->getParentScope()->addVariable(var);
   }
   return true;
@@ -569,6 +572,7 @@ bool TestbenchElaboration::bindForeachLoop_(ClassDefinition* classDefinition,
                                             ForeachLoopStmt* st) {
   NodeId arrayId = st->getArrayId();
   const FileContent* sfC = st->getFileContent();
+  Design* const design = m_compileDesign->getCompiler()->getDesign();
   std::vector<std::string> var_chain;
   computeVarChain(sfC, arrayId, var_chain);
   Variable* arrayVar =
@@ -591,13 +595,13 @@ bool TestbenchElaboration::bindForeachLoop_(ClassDefinition* classDefinition,
     } else if (rangeType == VObjectType::slAssociative_dimension ||
                rangeType == VObjectType::slQueue_dimension) {
       // Integer Type
-      itrDataType = new DataType(sfC, arrayId, "integer",
-                                 VObjectType::slIntegerAtomType_Int);
+      itrDataType = design->getDataTypeArena().make(
+          sfC, arrayId, "integer", VObjectType::slIntegerAtomType_Int);
     }
 
     for (auto itrId : st->getIteratorIds()) {
-      Variable* var = new Variable(itrDataType, sfC, itrId, InvalidNodeId,
-                                   sfC->SymName(itrId));
+      Variable* var = design->getVariableArena().make(
+          itrDataType, sfC, itrId, InvalidNodeId, sfC->SymName(itrId));
       st->getParentScope()->addVariable(var);
     }
   }
@@ -1617,7 +1617,7 @@ bool UhdmWriter::writeElabProgram(Serializer& s, ModuleInstance* instance,
     }
   }
 
-  if (mod) {
+  if (mod && lateBindingDue(mod)) {
     lateTypedefBinding(s, mod, m, componentMap);
     lateBinding(s, mod, m, componentMap);
   }
@@ -1876,7 +1876,7 @@ bool UhdmWriter::writeElabGenScope(Serializer& s, ModuleInstance* instance,
     }
   }
 
-  if (mod) {
+  if (mod && lateBindingDue(mod)) {
     lateTypedefBinding(s, mod, m, componentMap);
     lateBinding(s, mod, m, componentMap);
   }
@@ -1884,6 +1884,15 @@ bool UhdmWriter::writeElabGenScope(Serializer& s, ModuleInstance* instance,
   return true;
 }
 
+bool UhdmWriter::lateBindingDue(DesignComponent* mod) {
+  if (!m_compileDesign->getCompiler()
+           ->getCommandLineParser()
+           ->lateBindPerDefinition()) {
+    return true;
+  }
+  return m_lateBoundComponents.insert(mod).second;
+}
+
 void UhdmWriter::lateTypedefBinding(UHDM::Serializer& s, DesignComponent* mod,
                                     scope* m, ComponentMap& componentMap) {
   FileSystem* const fileSystem = FileSystem::getInstance();
@@ -3114,7 +3123,7 @@ bool UhdmWriter::writeElabModule(Serializer& s, ModuleInstance* instance,
     }
   }
 
-  if (mod) {
+  if (mod && lateBindingDue(mod)) {
     lateTypedefBinding(s, mod, m, componentMap);
     lateBinding(s, mod, m, componentMap);
     lateTypedefBinding(s, mod, m, componentMap);
@@ -3286,7 +3295,7 @@ bool UhdmWriter::writeElabInterface(Serializer& s, ModuleInstance* instance,
     }
   }
 
-  if (mod) {
+  if (mod && lateBindingDue(mod)) {
     lateTypedefBinding(s, mod, m, componentMap);
     lateBinding(s, mod, m, componentMap);
   }
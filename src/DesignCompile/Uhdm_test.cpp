@@ -14,23 +14,129 @@
  limitations under the License.
 */
 
+#include <Surelog/API/Surelog.h>
+#include <Surelog/CommandLine/CommandLineParser.h>
+#include <Surelog/Common/PlatformFileSystem.h>
 #include <Surelog/Design/Design.h>
 #include <Surelog/DesignCompile/CompileDesign.h>
 #include <Surelog/DesignCompile/CompileHelper.h>
 #include <Surelog/DesignCompile/ElaboratorHarness.h>
+#include <Surelog/ErrorReporting/ErrorContainer.h>
 #include <Surelog/SourceCompile/Compiler.h>
+#include <Surelog/SourceCompile/SymbolTable.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
 // UHDM
 #include <uhdm/design.h>
 #include <uhdm/uhdm.h>
+#include <uhdm/vpi_visitor.h>
 
 namespace SURELOG {
 
+namespace fs = std::filesystem;
 using ::testing::ElementsAre;
 
 namespace {
+class TestFileSystem : public PlatformFileSystem {
+ public:
+  explicit TestFileSystem(const fs::path& wd) : PlatformFileSystem(wd) {
+    FileSystem::setInstance(this);
+  }
+};
+
+// One line per continuous assign of each top, with what its right hand side
+// reference got bound to by the elaborator.
+std::vector<std::string> describeElaboratedTops(
+    const fs::path& file, const std::string& elabOption) {
+  const fs::path kProgramFile = FileSystem::getProgramPath();
+  std::unique_ptr<SymbolTable> symbolTable(new SymbolTable);
+  std::unique_ptr<ErrorContainer> errors(new ErrorContainer(symbolTable.get()));
+  std::unique_ptr<CommandLineParser> clp(
+      new CommandLineParser(errors.get(), symbolTable.get(), false, false));
+  std::vector<std::string> args{kProgramFile.string(),
+                                "-nostdout",
+                                "-nobuiltin",
+                                "-parse",
+                                elabOption,
+                                file.string(),
+                                "-o",
+                                (file.parent_path() / "out").string()};
+  std::vector<const char*> cargs;
+  std::transform(args.begin(), args.end(), std::back_inserter(cargs),
+                 [](const std::string& arg) { return arg.data(); });
+  clp->parseCommandLine(cargs.size(), cargs.data());
+
+  std::vector<std::string> lines;
+  scompiler* compiler = start_compiler(clp.get());
+  if (compiler == nullptr) return lines;
+  for (std::string_view topName : {"work@top1", "work@top2"}) {
+    vpiHandle h = get_uhdm_elaborated_top(compiler, topName);
+    if (h == nullptr) {
+      lines.emplace_back(std::string(topName) + " missing");
+      continue;
+    }
+    const UHDM::module* top =
+        (const UHDM::module*)((const uhdm_handle*)h)->object;
+    lines.emplace_back(std::string(top->VpiName()) + " elaborated " +
+                       std::to_string(top->VpiTop()));
+    if (top->Cont_assigns() != nullptr) {
+      for (const UHDM::cont_assign* assign : *top->Cont_assigns()) {
+        std::string line = std::string(assign->Lhs()->VpiName()) + " = " +
+                           std::to_string(assign->Rhs()->UhdmType());
+        if (const UHDM::ref_obj* ref =
+                UHDM::any_cast<const UHDM::ref_obj*>(assign->Rhs())) {
+          line += " -> ";
+          line += (ref->Actual_group() == nullptr)
+                      ? "unbound"
+                      : std::to_string(ref->Actual_group()->UhdmType());
+        }
+        lines.emplace_back(line);
+      }
+    }
+    vpi_release_handle(h);
+  }
+  shutdown_compiler(compiler);
+  return lines;
+}
+
+// The UHDM model of the design, as printed by -d uhdm.
+std::string dumpUhdm(const fs::path& file, bool lateBindPerDefinition) {
+  const fs::path kProgramFile = FileSystem::getProgramPath();
+  std::unique_ptr<SymbolTable> symbolTable(new SymbolTable);
+  std::unique_ptr<ErrorContainer> errors(new ErrorContainer(symbolTable.get()));
+  std::unique_ptr<CommandLineParser> clp(
+      new CommandLineParser(errors.get(), symbolTable.get(), false, false));
+  std::vector<std::string> args{kProgramFile.string(),
+                                "-nostdout",
+                                "-nobuiltin",
+                                "-nocache",
+                                "-parse",
+                                file.string(),
+                                "-o",
+                                (file.parent_path() / "out").string()};
+  std::vector<const char*> cargs;
+  std::transform(args.begin(), args.end(), std::back_inserter(cargs),
+                 [](const std::string& arg) { return arg.data(); });
+  clp->parseCommandLine(cargs.size(), cargs.data());
+  clp->setLateBindPerDefinition(lateBindPerDefinition);
+
+  std::ostringstream dump;
+  scompiler* compiler = start_compiler(clp.get());
+  if (compiler == nullptr) return dump.str();
+  vpi_show_ids(false);
+  visit_designs({get_uhdm_design(compiler)}, dump);
+  shutdown_compiler(compiler);
+  return dump.str();
+}
 
 TEST(Uhdm, PortType) {
   CompileHelper helper;
@@ -116,5 +222,100 @@ TEST(Uhdm, Unsigned) {
     }
   }
 }
+
+TEST(Uhdm, LazyElaborationBindsPackageReferences) {
+  const fs::path kBaseDir = fs::path(testing::TempDir()) / "uhdm_lazy_elab";
+  std::error_code ec;
+  fs::remove_all(kBaseDir, ec);
+  fs::create_directories(kBaseDir, ec);
+  std::unique_ptr<FileSystem> fileSystem(new TestFileSystem(kBaseDir));
+
+  // Both tops reference the package, so the second elaborated top must see
+  // the package scope just like the first one.
+  const fs::path file = kBaseDir / "dut.sv";
+  SymbolTable symbolTable;
+  const PathId fileId = fileSystem->toPathId(file.string(), &symbolTable);
+  std::ostream& strm = fileSystem->openForWrite(fileId);
+  strm << R"(
+  package pkg;
+    logic [3:0] shared;
+    typedef logic [3:0] word_t;
+  endpackage
+  module top1(output pkg::word_t o);
+    import pkg::*;
+    assign o = shared;
+  endmodule
+  module top2(output pkg::word_t o);
+    assign o = pkg::shared;
+  endmodule
+  )";
+  fileSystem->close(strm);
+
+  const std::vector<std::string> eager =
+      describeElaboratedTops(file, "-elabuhdm");
+  const std::vector<std::string> lazy =
+      describeElaboratedTops(file, "-lazyelabuhdm");
+  ASSERT_EQ(eager.size(), 4);
+  EXPECT_EQ(lazy, eager);
+  for (const std::string& line : lazy) {
+    EXPECT_EQ(line.find("unbound"), std::string::npos) << line;
+  }
+
+  fs::remove_all(kBaseDir, ec);
+}
+
+TEST(Uhdm, LateBindingOncePerDefinition) {
+  const fs::path kBaseDir = fs::path(testing::TempDir()) / "uhdm_late_binding";
+  std::error_code ec;
+  fs::remove_all(kBaseDir, ec);
+  fs::create_directories(kBaseDir, ec);
+  std::unique_ptr<FileSystem> fileSystem(new TestFileSystem(kBaseDir));
+
+  // Several instances of the same module, interface and generate scope, with
+  // references to package items, ports, interface members and implicit nets
+  // left to the late binding.
+  const fs::path file = kBaseDir / "dut.sv";
+  SymbolTable symbolTable;
+  const PathId fileId = fileSystem->toPathId(file.string(), &symbolTable);
+  std::ostream& strm = fileSystem->openForWrite(fileId);
+  strm << R"(
+  package pkg;
+    typedef logic [3:0] word_t;
+    parameter word_t INIT = 4'h5;
+  endpackage
+  interface bus_if;
+    pkg::word_t data;
+  endinterface
+  module leaf #(parameter int W = 4)(input pkg::word_t i,
+                                     output pkg::word_t o, bus_if b);
+    import pkg::*;
+    word_t r;
+    assign implicit_n = i[0];
+    assign r = i ^ INIT;
+    assign o = r;
+    assign b.data = r;
+    for (genvar g = 0; g < 2; g++) begin : gen
+      word_t t;
+      assign t = i + g;
+    end
+  endmodule
+  module top(input pkg::word_t i, output pkg::word_t o1, o2, o3);
+    bus_if b1();
+    bus_if b2();
+    bus_if b3();
+    leaf u1(.i(i), .o(o1), .b(b1));
+    leaf #(.W(8)) u2(.i(i), .o(o2), .b(b2));
+    leaf u3(.i(i), .o(o3), .b(b3));
+  endmodule
+  )";
+  fileSystem->close(strm);
+
+  const std::string perInstance = dumpUhdm(file, false);
+  const std::string perDefinition = dumpUhdm(file, true);
+  EXPECT_NE(perInstance.find("work@top.u3"), std::string::npos);
+  EXPECT_EQ(perDefinition, perInstance);
+
+  fs::remove_all(kBaseDir, ec);
+}
 }  // namespace
 }  // namespace SURELOG
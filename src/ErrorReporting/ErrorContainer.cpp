@@ -29,6 +29,7 @@
 #include <Surelog/ErrorReporting/LogListener.h>
 #include <Surelog/ErrorReporting/Waiver.h>
 #include <Surelog/SourceCompile/SymbolTable.h>
+#include <Surelog/Utils/StringUtils.h>
 #include <antlr4-runtime.h>
 #include <stdio.h>
 
@@ -66,36 +67,52 @@ void ErrorContainer::init() {
   }
 }
 
+bool ErrorContainer::isFiltered_(ErrorDefinition::ErrorType type) const {
+  const std::map<ErrorDefinition::ErrorType, ErrorDefinition::ErrorInfo>&
+      infoMap = ErrorDefinition::getErrorInfoMap();
+  std::map<ErrorDefinition::ErrorType,
+           ErrorDefinition::ErrorInfo>::const_iterator itr = infoMap.find(type);
+  if (itr == infoMap.end()) return false;
+  switch ((*itr).second.m_severity) {
+    case ErrorDefinition::WARNING:
+      return m_clp->filterWarning();
+    case ErrorDefinition::INFO:
+      return m_clp->filterInfo() &&
+             (type != ErrorDefinition::PP_PROCESSING_SOURCE_FILE);
+    case ErrorDefinition::NOTE:
+      return m_clp->filterNote();
+    default:
+      return false;
+  }
+}
+
 Error& ErrorContainer::addError(Error& error, bool showDuplicates,
                                 bool reentrantPython) {
-  std::tuple<std::string, bool, bool> textStatus =
-      createErrorMessage(error, reentrantPython);
-  if (std::get<2>(textStatus))  // filter Message
-    return error;
-
   FileSystem* const fileSystem = FileSystem::getInstance();
-  std::multimap<ErrorDefinition::ErrorType, Waiver::WaiverData>& waivers =
-      Waiver::getWaivers();
-  std::pair<
-      std::multimap<ErrorDefinition::ErrorType, Waiver::WaiverData>::iterator,
-      std::multimap<ErrorDefinition::ErrorType, Waiver::WaiverData>::iterator>
-      ret = waivers.equal_range(error.m_errorId);
-  for (std::multimap<ErrorDefinition::ErrorType, Waiver::WaiverData>::iterator
-           it = ret.first;
-       it != ret.second; ++it) {
-    if ((((*it).second.m_fileName.empty()) ||
-         (fileSystem->toPath(error.m_locations[0].m_fileId) ==
-          (*it).second.m_fileName)) &&
-        (((*it).second.m_line == 0) ||
-         (error.m_locations[0].m_line == (*it).second.m_line)) &&
-        (((*it).second.m_objectId.empty()) ||
-         (m_symbolTable->getSymbol(error.m_locations[0].m_object) ==
-          (*it).second.m_objectId))) {
+  // Resolve waivers before formatting, a waived message is never printed
+  if (!error.m_waived && Waiver::hasWaivers(error.m_errorId)) {
+    const Location& loc = error.m_locations[0];
+    if (Waiver::isWaived(error.m_errorId, fileSystem->toPath(loc.m_fileId),
+                         loc.m_line, m_symbolTable->getSymbol(loc.m_object))) {
       error.m_waived = true;
-      break;
     }
   }
 
+  std::string key;
+  if (error.m_waived) {
+    if (isFiltered_(error.m_errorId)) return error;
+    const Location& loc = error.m_locations[0];
+    key = StrCat("waived:", error.m_errorId, ":",
+                 fileSystem->toPath(loc.m_fileId), ":", loc.m_line, ":",
+                 loc.m_column, ":", m_symbolTable->getSymbol(loc.m_object));
+  } else {
+    std::tuple<std::string, bool, bool> textStatus =
+        createErrorMessage(error, reentrantPython);
+    if (std::get<2>(textStatus))  // filter Message
+      return error;
+    key = std::move(std::get<0>(textStatus));
+  }
+
   // Copy the PathId into our local SymbolTable!
   for (Location& loc : error.m_locations) {
     if (loc.m_fileId) {
@@ -106,9 +123,9 @@ Error& ErrorContainer::addError(Error& error, bool showDuplicates,
   if (showDuplicates) {
     m_errors.emplace_back(error);
   } else {
-    if (m_errorSet.find(std::get<0>(textStatus)) == m_errorSet.end()) {
+    if (m_errorSet.find(key) == m_errorSet.end()) {
       m_errors.emplace_back(error);
-      m_errorSet.insert(std::get<0>(textStatus));
+      m_errorSet.insert(std::move(key));
     }
   }
   return m_errors.back();
@@ -202,6 +202,8 @@ bool ErrorDefinition::init() {
       "Current directory option \"%s\" is missing directory");
   rec(CMD_REMAP_MISSING_DIRS, WARNING, CMD,
       "Remapping option \"%s\" expects two absolute directory entries");
+  rec(CMD_BOUNDEDMEM_MISSING_SIZE, FATAL, CMD,
+      "Missing maximum number of files for bounded memory parsing");
   rec(PP_CANNOT_OPEN_FILE, ERROR, PP, "Cannot open file \"%s\"");
   rec(PP_CANNOT_OPEN_INCLUDE_FILE, ERROR, PP,
       "Cannot open include file \"%s\"");
@@ -27,154 +27,129 @@
 #include <Surelog/SourceCompile/SymbolTable.h>
 #include <Surelog/Utils/StringUtils.h>
 
-#include <chrono>
 #include <filesystem>
+#include <iomanip>
 #include <iostream>
-#include <regex>
-#include <thread>
-
-#if !(defined(_MSC_VER) || defined(__MINGW32__) || defined(__CYGWIN__))
-#include <unistd.h>
-#endif
-
-#include <Surelog/ErrorReporting/ErrorContainer.h>
+#include <map>
 
 namespace SURELOG {
 
 namespace fs = std::filesystem;
 
-struct Result {
-  std::string m_nbFatal;
-  std::string m_nbSyntax;
-  std::string m_nbError;
-  std::string m_nbWarning;
-  std::string m_nbNote;
-  std::string m_nbInfo;
-};
+void Report::collectResult(const ErrorContainer* errors, Result& result) {
+  result.m_stats = errors->getErrorStats();
+  for (const Error& error : errors->getErrors()) {
+    if (error.m_waived) continue;
+    // Messages are marked reported once printed, format a fresh copy
+    Error msg = error;
+    msg.m_reported = false;
+    std::tuple<std::string, bool, bool> textStatus =
+        errors->createErrorMessage(msg, false);
+    const std::string& text = std::get<0>(textStatus);
+    if (std::get<2>(textStatus) || text.empty()) continue;
+    result.m_messages.emplace(StringUtils::rtrim(text));
+  }
+}
 
-bool parseReportFile(PathId logFileId, Result& result) {
+// Preprocessed files relative to their library directory
+static std::map<fs::path, PathId> collectPpFiles(PathId compileDirId,
+                                                 SymbolTable* st) {
   FileSystem* const fileSystem = FileSystem::getInstance();
-  bool ret = false;
-  std::istream& ifs = fileSystem->openForRead(logFileId);
-  if (ifs.good()) {
-    std::string line;
-    while (std::getline(ifs, line)) {
-      if (ifs.bad()) break;
-      line = StringUtils::rtrim(line);
-      if (line.find("[  FATAL] : ") == 0) {
-        result.m_nbFatal = line.substr(12);
-      }
-      if (line.find("[ SYNTAX] : ") == 0) {
-        result.m_nbSyntax = line.substr(12);
-      }
-      if (line.find("[  ERROR] : ") == 0) {
-        result.m_nbError = line.substr(12);
-      }
-      if (line.find("[WARNING] : ") == 0) {
-        result.m_nbWarning = line.substr(12);
-      }
-      if (line.find("[   NOTE] : ") == 0) {
-        result.m_nbNote = line.substr(12);
-        ret = true;
-      }
-      if (line.find("[   INFO] : ") == 0) {
-        result.m_nbInfo = line.substr(12);
-        ret = true;
-      }
-    }
+  const PathId libDirId = fileSystem->getChild(
+      compileDirId, FileSystem::kPreprocessLibraryDirName, st);
+  std::map<fs::path, PathId> files;
+  if (!fileSystem->isDirectory(libDirId)) return files;
+  const fs::path libDir = fileSystem->toPlatformPath(libDirId);
+  PathIdVector container;
+  fileSystem->collect(libDirId, st, container);
+  for (const PathId& fileId : container) {
+    files.emplace(fileSystem->toPlatformPath(fileId).lexically_relative(libDir),
+                  fileId);
   }
-  fileSystem->close(ifs);
-  return ret;
+  return files;
 }
 
 std::pair<bool, bool> Report::makeDiffCompUnitReport(CommandLineParser* clp,
-                                                     SymbolTable* st) {
-  // std::mutex m;
-  // m.lock();
-  constexpr std::string_view kDiffLogFileName = "diff.log";
+                                                     SymbolTable* st,
+                                                     const Result& unitResult,
+                                                     const Result& allResult) {
   FileSystem* const fileSystem = FileSystem::getInstance();
-  const PathId outputDirId = clp->getOutputDirId();
   const PathId allLogFileId = fileSystem->getLogFile(false, st);
   const PathId unitLogFileId = fileSystem->getLogFile(true, st);
-  const PathId diffFileId =
-      fileSystem->getChild(outputDirId, kDiffLogFileName, st);
-
-  bool readAll = false;
-  bool readUnit = false;
-  Result readAllResult;
-  Result readUnitResult;
-
-  while ((!readAll) || (!readUnit)) {
-    std::this_thread::sleep_for(std::chrono::microseconds(1000));
-    if (!readAll) {
-      readAll = parseReportFile(allLogFileId, readAllResult);
-    }
-    if (!readUnit) {
-      readUnit = parseReportFile(unitLogFileId, readUnitResult);
-    }
-  }
+  const ErrorContainer::Stats& unitStats = unitResult.m_stats;
+  const ErrorContainer::Stats& allStats = allResult.m_stats;
 
   std::cout << "|-------|------------------|-------------------|" << std::endl;
   std::cout << "|       |  FILE UNIT COMP  |  ALL COMPILATION  |" << std::endl;
   std::cout << "|-------|------------------|-------------------|" << std::endl;
-  std::cout << "| FATAL | " << std::setw(9) << readUnitResult.m_nbFatal
-            << "        | " << std::setw(9) << readAllResult.m_nbFatal
+  std::cout << "| FATAL | " << std::setw(9) << unitStats.nbFatal
+            << "        | " << std::setw(9) << allStats.nbFatal
             << "         |" << std::endl;
-  std::cout << "|SYNTAX | " << std::setw(9) << readUnitResult.m_nbSyntax
-            << "        | " << std::setw(9) << readAllResult.m_nbSyntax
+  std::cout << "|SYNTAX | " << std::setw(9) << unitStats.nbSyntax
+            << "        | " << std::setw(9) << allStats.nbSyntax
             << "         |" << std::endl;
-  std::cout << "| ERROR | " << std::setw(9) << readUnitResult.m_nbError
-            << "        | " << std::setw(9) << readAllResult.m_nbError
+  std::cout << "| ERROR | " << std::setw(9) << unitStats.nbError
+            << "        | " << std::setw(9) << allStats.nbError
             << "         |" << std::endl;
-  std::cout << "|WARNING| " << std::setw(9) << readUnitResult.m_nbWarning
-            << "        | " << std::setw(9) << readAllResult.m_nbWarning
+  std::cout << "|WARNING| " << std::setw(9) << unitStats.nbWarning
+            << "        | " << std::setw(9) << allStats.nbWarning
             << "         |" << std::endl;
-  std::cout << "| INFO  | " << std::setw(9) << readUnitResult.m_nbInfo
-            << "        | " << std::setw(9) << readAllResult.m_nbInfo
+  std::cout << "| INFO  | " << std::setw(9) << unitStats.nbInfo
+            << "        | " << std::setw(9) << allStats.nbInfo
             << "         |" << std::endl;
-  std::cout << "| NOTE  | " << std::setw(9) << readUnitResult.m_nbNote
-            << "        | " << std::setw(9) << readAllResult.m_nbNote
+  std::cout << "| NOTE  | " << std::setw(9) << unitStats.nbNote
+            << "        | " << std::setw(9) << allStats.nbNote
             << "         |" << std::endl;
   std::cout << "|-------|------------------|-------------------|" << std::endl;
   std::cout << std::endl;
   std::cout << "FILE UNIT LOG: " << PathIdPP(unitLogFileId) << std::endl;
   std::cout << "ALL FILES LOG: " << PathIdPP(allLogFileId) << std::endl;
 
+  // Files that preprocess differently under the two semantics
   const PathId allCompileDirId = fileSystem->getCompileDir(false, st);
   const PathId unitCompileDirId = fileSystem->getCompileDir(true, st);
-  const fs::path allCompileDir = fileSystem->toPlatformPath(allCompileDirId);
-  const fs::path unitCompileDir = fileSystem->toPlatformPath(unitCompileDirId);
-  const fs::path diffFile = fileSystem->toPlatformPath(diffFileId);
-
-  std::string diffCmd = StrCat("diff -r ", unitCompileDir, " ", allCompileDir,
-                               " --exclude cache --brief > ", diffFile);
-  int retval = system(diffCmd.c_str());
-
-  std::istream& ifs = fileSystem->openForRead(diffFileId);
-  if (ifs.good()) {
-    std::cout << "\nDIFFS:" << std::endl;
-    std::string line;
-    while (std::getline(ifs, line)) {
-      if (line.find(kDiffLogFileName) != std::string::npos) {
-        continue;
-      }
-      if (line.find(FileSystem::kLogFileName) != std::string::npos) {
-        continue;
-      }
-
-      line = std::regex_replace(line, std::regex("Files "), "");
-      line = std::regex_replace(line, std::regex("differ"), "");
-      std::cout << line << std::endl;
+  const std::map<fs::path, PathId> unitFiles =
+      collectPpFiles(unitCompileDirId, st);
+  const std::map<fs::path, PathId> allFiles =
+      collectPpFiles(allCompileDirId, st);
+  std::cout << "\nDIFFS:" << std::endl;
+  for (const auto& [relPath, unitFileId] : unitFiles) {
+    auto found = allFiles.find(relPath);
+    if (found == allFiles.end()) {
+      std::cout << "Only in " << PathIdPP(unitCompileDirId) << ": "
+                << relPath.string() << std::endl;
+      continue;
+    }
+    std::string unitText;
+    std::string allText;
+    fileSystem->readContent(unitFileId, unitText);
+    fileSystem->readContent(found->second, allText);
+    if (unitText != allText) {
+      std::cout << PathIdPP(unitFileId) << " and "
+                << PathIdPP(found->second) << std::endl;
+    }
+  }
+  for (const auto& [relPath, allFileId] : allFiles) {
+    if (unitFiles.find(relPath) == unitFiles.end()) {
+      std::cout << "Only in " << PathIdPP(allCompileDirId) << ": "
+                << relPath.string() << std::endl;
     }
   }
-  fileSystem->close(ifs);
 
-  int nbFatal =
-      std::stoi(readUnitResult.m_nbFatal) + std::stoi(readAllResult.m_nbFatal);
-  int nbSyntax = std::stoi(readUnitResult.m_nbSyntax) +
-                 std::stoi(readAllResult.m_nbSyntax);
+  // Messages reported by only one of the compilations
+  std::cout << "\nONLY IN FILE UNIT:" << std::endl;
+  for (const std::string& msg : unitResult.m_messages) {
+    if (allResult.m_messages.find(msg) == allResult.m_messages.end())
+      std::cout << msg << std::endl;
+  }
+  std::cout << "\nONLY IN ALL FILES:" << std::endl;
+  for (const std::string& msg : allResult.m_messages) {
+    if (unitResult.m_messages.find(msg) == unitResult.m_messages.end())
+      std::cout << msg << std::endl;
+  }
 
-  // m.unlock();
-  return std::make_pair(retval != -1, (!nbFatal) && (!nbSyntax));
+  const int nbFatal = unitStats.nbFatal + allStats.nbFatal;
+  const int nbSyntax = unitStats.nbSyntax + allStats.nbSyntax;
+  return std::make_pair(true, (!nbFatal) && (!nbSyntax));
 }
 }  // namespace SURELOG
@@ -31,18 +31,117 @@
 namespace SURELOG {
 
 std::set<std::string> Waiver::m_macroArgCheck;
-std::multimap<ErrorDefinition::ErrorType, Waiver::WaiverData> Waiver::m_waivers;
+std::unordered_set<ErrorDefinition::ErrorType> Waiver::m_waivedTypes;
+std::set<std::string, std::less<>> Waiver::m_waiverStringStorage;
+std::unordered_map<std::string_view, uint32_t> Waiver::m_waiverStrings;
+std::unordered_set<Waiver::WaiverKey, Waiver::WaiverKeyHash>
+    Waiver::m_exactWaivers;
+std::multimap<ErrorDefinition::ErrorType, Waiver::WaiverData>
+    Waiver::m_globWaivers;
 
 // Example of message to waive:
 // [WARNI:PP0113] ../../../UVM/uvm-1.2/src/macros/uvm_callback_defines.svh, line
 // 294, col 8: Unused macro argument "CB".
 
+static bool isGlob(std::string_view name) {
+  return name.find_first_of("*?") != std::string_view::npos;
+}
+
+uint32_t Waiver::internWaiverString_(std::string_view str) {
+  if (str.empty()) return 0;
+  auto found = m_waiverStrings.find(str);
+  if (found != m_waiverStrings.end()) return found->second;
+  const std::string& stored = *m_waiverStringStorage.emplace(str).first;
+  const uint32_t id = m_waiverStrings.size() + 1;
+  m_waiverStrings.emplace(stored, id);
+  return id;
+}
+
+uint32_t Waiver::getWaiverString_(std::string_view str) {
+  auto found = m_waiverStrings.find(str);
+  return (found == m_waiverStrings.end()) ? 0 : found->second;
+}
+
 void Waiver::setWaiver(const std::string& messageId,
                        const std::string& fileName, unsigned int line,
                        const std::string& objectName) {
   ErrorDefinition::ErrorType type = ErrorDefinition::getErrorType(messageId);
-  Waiver::WaiverData data(type, fileName, line, objectName);
-  m_waivers.emplace(type, data);
+  m_waivedTypes.insert(type);
+  if (isGlob(fileName) || isGlob(objectName)) {
+    Waiver::WaiverData data(type, fileName, line, objectName);
+    m_globWaivers.emplace(type, data);
+  } else {
+    m_exactWaivers.insert({type, internWaiverString_(fileName), line,
+                           internWaiverString_(objectName)});
+  }
+}
+
+void Waiver::clearWaivers() {
+  m_waivedTypes.clear();
+  m_exactWaivers.clear();
+  m_globWaivers.clear();
+  m_waiverStrings.clear();
+  m_waiverStringStorage.clear();
+}
+
+bool Waiver::globMatch(std::string_view pattern, std::string_view text) {
+  size_t p = 0;
+  size_t t = 0;
+  size_t starP = std::string_view::npos;
+  size_t starT = 0;
+  while (t < text.size()) {
+    if ((p < pattern.size()) &&
+        ((pattern[p] == '?') || (pattern[p] == text[t]))) {
+      p++;
+      t++;
+    } else if ((p < pattern.size()) && (pattern[p] == '*')) {
+      starP = p++;
+      starT = t;
+    } else if (starP != std::string_view::npos) {
+      // Let the last star absorb one more character
+      p = starP + 1;
+      t = ++starT;
+    } else {
+      return false;
+    }
+  }
+  while ((p < pattern.size()) && (pattern[p] == '*')) p++;
+  return p == pattern.size();
+}
+
+bool Waiver::isWaived(ErrorDefinition::ErrorType messageId,
+                      std::string_view fileName, unsigned int line,
+                      std::string_view objectName) {
+  if (!hasWaivers(messageId)) return false;
+
+  // Exact waivers: probe the 8 combinations of specified/any fields.
+  // A name never seen in a waiver interns to 0 and can only match "any".
+  if (!m_exactWaivers.empty()) {
+    const uint32_t fileIds[2] = {getWaiverString_(fileName), 0};
+    const unsigned int lines[2] = {line, 0};
+    const uint32_t objectIds[2] = {getWaiverString_(objectName), 0};
+    for (uint32_t fileId : fileIds) {
+      for (unsigned int l : lines) {
+        for (uint32_t objectId : objectIds) {
+          if (m_exactWaivers.find({messageId, fileId, l, objectId}) !=
+              m_exactWaivers.end()) {
+            return true;
+          }
+        }
+      }
+    }
+  }
+
+  auto range = m_globWaivers.equal_range(messageId);
+  for (auto it = range.first; it != range.second; ++it) {
+    const WaiverData& data = it->second;
+    if ((data.m_fileName.empty() || globMatch(data.m_fileName, fileName)) &&
+        ((data.m_line == 0) || (data.m_line == line)) &&
+        (data.m_objectId.empty() || globMatch(data.m_objectId, objectName))) {
+      return true;
+    }
+  }
+  return false;
 }
 
 void Waiver::initWaivers() { m_macroArgCheck.insert("vmm_sformatf"); }
@@ -0,0 +1,64 @@
+/*
+ Copyright 2022 The Surelog Team.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include <Surelog/ErrorReporting/Waiver.h>
+#include <gtest/gtest.h>
+
+namespace SURELOG {
+namespace {
+// The waiver tables are process wide, each test starts and ends without any.
+class WaiverTest : public ::testing::Test {
+ protected:
+  void SetUp() override { Waiver::clearWaivers(); }
+  void TearDown() override { Waiver::clearWaivers(); }
+};
+}  // namespace
+
+TEST_F(WaiverTest, GlobMatch) {
+  EXPECT_TRUE(Waiver::globMatch("", ""));
+  EXPECT_TRUE(Waiver::globMatch("*", ""));
+  EXPECT_TRUE(Waiver::globMatch("*", "anything"));
+  EXPECT_TRUE(Waiver::globMatch("a?c", "abc"));
+  EXPECT_FALSE(Waiver::globMatch("a?c", "ac"));
+  EXPECT_TRUE(Waiver::globMatch("*/uvm-1.2/*.svh", "../UVM/uvm-1.2/src/a.svh"));
+  EXPECT_FALSE(Waiver::globMatch("*/uvm-1.2/*.svh", "../UVM/uvm-1.2/a.sv"));
+  EXPECT_TRUE(Waiver::globMatch("a*b*c", "aXbYbZc"));
+  EXPECT_FALSE(Waiver::globMatch("a*b*c", "aXbYbZ"));
+}
+
+TEST_F(WaiverTest, Lookup) {
+  const ErrorDefinition::ErrorType type =
+      ErrorDefinition::getErrorType("[WARNI:PP0113]");
+  EXPECT_FALSE(Waiver::hasWaivers(type));
+
+  Waiver::setWaiver("[WARNI:PP0113]", "top.sv", 12, "");
+  Waiver::setWaiver("[WARNI:PP0113]", "", 0, "CB");
+  Waiver::setWaiver("[WARNI:PP0113]", "*/macros/*.svh", 0, "ARG?");
+  EXPECT_TRUE(Waiver::hasWaivers(type));
+
+  EXPECT_TRUE(Waiver::isWaived(type, "top.sv", 12, "X"));
+  EXPECT_FALSE(Waiver::isWaived(type, "top.sv", 13, "X"));
+  EXPECT_TRUE(Waiver::isWaived(type, "other.sv", 13, "CB"));
+  EXPECT_TRUE(Waiver::isWaived(type, "uvm/macros/cb.svh", 5, "ARG1"));
+  EXPECT_FALSE(Waiver::isWaived(type, "uvm/macros/cb.svh", 5, "ARG10"));
+  EXPECT_FALSE(Waiver::isWaived(type, "uvm/src/cb.svh", 5, "ARG1"));
+
+  Waiver::clearWaivers();
+  EXPECT_FALSE(Waiver::hasWaivers(type));
+  EXPECT_FALSE(Waiver::isWaived(type, "top.sv", 12, "X"));
+  EXPECT_FALSE(Waiver::isWaived(type, "other.sv", 13, "CB"));
+}
+}  // namespace SURELOG
@@ -63,4 +63,33 @@ bool Precompiled::isPackagePrecompiled(std::string_view packageName) const {
   return (m_packageMap.find(packageName) != m_packageMap.end());
 }
 
+std::shared_ptr<const std::vector<char>> Precompiled::loadImage(
+    PathId imageFileId) {
+  if (!imageFileId) return nullptr;
+
+  FileSystem* const fileSystem = FileSystem::getInstance();
+  const std::string_view imagePath = fileSystem->toPath(imageFileId);
+  const std::filesystem::file_time_type modtime =
+      fileSystem->modtime(imageFileId);
+  if (modtime == std::filesystem::file_time_type::min()) return nullptr;
+
+  std::scoped_lock<std::mutex> lock(m_imageMutex);
+  auto found = m_images.find(imagePath);
+  if ((found != m_images.end()) && (found->second.m_modtime == modtime)) {
+    if (std::shared_ptr<const std::vector<char>> content =
+            found->second.m_content.lock()) {
+      return content;
+    }
+  }
+
+  std::shared_ptr<std::vector<char>> content =
+      std::make_shared<std::vector<char>>();
+  if (!fileSystem->loadContent(imageFileId, *content)) return nullptr;
+
+  Image& image = m_images[std::string(imagePath)];
+  image.m_modtime = modtime;
+  image.m_content = content;
+  return content;
+}
+
 }  // namespace SURELOG
@@ -0,0 +1,82 @@
+/*
+ Copyright 2021 Alain Dargelas
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include <Surelog/Common/PathId.h>
+#include <Surelog/Common/PlatformFileSystem.h>
+#include <Surelog/Package/Precompiled.h>
+#include <Surelog/SourceCompile/SymbolTable.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SURELOG {
+
+namespace fs = std::filesystem;
+
+namespace {
+class TestFileSystem : public PlatformFileSystem {
+ public:
+  explicit TestFileSystem(const fs::path &wd) : PlatformFileSystem(wd) {
+    FileSystem::setInstance(this);
+  }
+};
+
+TEST(PrecompiledTest, ImageReleasedAfterLastUse) {
+  const fs::path kBaseDir = fs::path(testing::TempDir()) / "precompiled";
+  std::error_code ec;
+  fs::remove_all(kBaseDir, ec);
+  fs::create_directories(kBaseDir, ec);
+  std::unique_ptr<FileSystem> fileSystem(new TestFileSystem(kBaseDir));
+
+  SymbolTable symbols;
+  const PathId imageId =
+      fileSystem->toPathId((kBaseDir / "uvm_pkg.slpp").string(), &symbols);
+  std::ostream &strm = fileSystem->openForWrite(imageId);
+  strm << "image content";
+  fileSystem->close(strm);
+
+  Precompiled *const precompiled = Precompiled::getSingleton();
+  std::shared_ptr<const std::vector<char>> check =
+      precompiled->loadImage(imageId);
+  ASSERT_NE(check, nullptr);
+  EXPECT_EQ(std::string(check->begin(), check->end()), "image content");
+
+  // The validity check and the restore share the image
+  std::shared_ptr<const std::vector<char>> restore =
+      precompiled->loadImage(imageId);
+  EXPECT_EQ(restore, check);
+
+  // Once both are done, the image is not pinned by Precompiled
+  std::weak_ptr<const std::vector<char>> observer = check;
+  check.reset();
+  restore.reset();
+  EXPECT_TRUE(observer.expired());
+
+  // and is read again on the next use
+  std::shared_ptr<const std::vector<char>> reloaded =
+      precompiled->loadImage(imageId);
+  ASSERT_NE(reloaded, nullptr);
+  EXPECT_EQ(std::string(reloaded->begin(), reloaded->end()), "image content");
+
+  EXPECT_EQ(precompiled->loadImage(BadPathId), nullptr);
+
+  fs::remove_all(kBaseDir, ec);
+}
+}  // namespace
+}  // namespace SURELOG
@@ -200,6 +200,7 @@ void AstListener::listen(PathId fileId,
   m_objects = objects;
   m_count = count;
   m_symbolTable = symbolTable;
+  m_visited.assign(count, false);
 
   const AstNode root(NodeId(count - 1), &objects[count - 1]);
 
@@ -211,21 +212,9 @@ void AstListener::listen(PathId fileId,
 void AstListener::listenChildren(const AstNode& node, bool ordered) {
   if (!node || !node.m_object->m_child) return;
 
-  std::vector<NodeId> indexes;
-  indexes.reserve(16);
-  for (NodeId id = node.m_object->m_child; id;
-       id = m_objects[(RawNodeId)id].m_sibling) {
-    indexes.emplace_back(id);
-  }
-
-  if (ordered) {
-    std::sort(indexes.begin(), indexes.end(), VObjectComparer(m_objects));
-  }
-
-  for (const NodeId& index : indexes) {
-    const AstNode node(index, &m_objects[(RawNodeId)index]);
-    listen(node);
-  }
+  const size_t depth = m_frames.size();
+  pushChildren_(node, node.m_object->m_child, InvalidNodeId, ordered, false);
+  walk_(depth);
 }
 
 void AstListener::listenSiblings(const AstNode& node, bool ordered) {
@@ -233,39 +222,92 @@ void AstListener::listenSiblings(const AstNode& node, bool ordered) {
 
   const VObject& parent = m_objects[(RawNodeId)node.m_object->m_parent];
 
-  std::vector<NodeId> indexes;
-  indexes.reserve(16);
-  for (NodeId id = parent.m_child; id;
-       id = m_objects[(RawNodeId)id].m_sibling) {
-    if (id != node.m_index) indexes.emplace_back(id);
-  }
+  const size_t depth = m_frames.size();
+  pushChildren_(node, parent.m_child, node.m_index, ordered, false);
+  walk_(depth);
+}
 
-  if (ordered) {
-    std::sort(indexes.begin(), indexes.end(), VObjectComparer(m_objects));
-  }
+void AstListener::listen(const AstNode& node) {
+  if (m_visited[(RawNodeId)node.m_index]) return;
 
-  for (const NodeId& index : indexes) {
-    const AstNode node(index, &m_objects[(RawNodeId)index]);
-    listen(node);
+  const size_t depth = m_frames.size();
+  visit_(node);
+  walk_(depth);
+}
+
+void AstListener::visit_(const AstNode& node) {
+  m_visited[(RawNodeId)node.m_index] = true;
+  m_callstack.emplace_back(node);
+  // The enter callback may itself listen to nodes, these complete their own
+  // frames before returning.
+  if (enterNode_(node)) {
+    pushChildren_(node, node.m_object->m_child, InvalidNodeId, true, true);
+  } else {
+    m_callstack.pop_back();
   }
 }
 
-// clang-format off
-<PRIVATE_LISTEN_IMPLEMENTATIONS>
-// clang-format on
+void AstListener::pushChildren_(const AstNode& node, NodeId first,
+                                NodeId skip, bool ordered, bool entered) {
+  Frame frame;
+  frame.m_node = node;
+  frame.m_begin = frame.m_next = m_children.size();
+  frame.m_entered = entered;
+
+  // Children are usually linked in source order already, only sort when
+  // they are not.
+  const VObjectComparer comparer(m_objects);
+  bool sorted = true;
+  for (NodeId id = first; id; id = m_objects[(RawNodeId)id].m_sibling) {
+    if (id == skip) continue;
+    if (ordered && sorted && (m_children.size() > frame.m_begin) &&
+        comparer(id, m_children.back())) {
+      sorted = false;
+    }
+    m_children.emplace_back(id);
+  }
+  if (!sorted) {
+    std::sort(m_children.begin() + frame.m_begin, m_children.end(), comparer);
+  }
+  frame.m_end = m_children.size();
+  m_frames.emplace_back(frame);
+}
 
-void AstListener::listen(const AstNode& node) {
-  if (!m_visited.insert(node).second) {
-    return;
+void AstListener::walk_(size_t depth) {
+  while (m_frames.size() > depth) {
+    Frame& frame = m_frames.back();
+    if (frame.m_next < frame.m_end) {
+      const NodeId id = m_children[frame.m_next++];
+      if (!m_visited[(RawNodeId)id]) {
+        visit_(AstNode(id, &m_objects[(RawNodeId)id]));
+      }
+    } else {
+      const Frame done = frame;
+      m_children.resize(done.m_begin);
+      m_frames.pop_back();
+      if (done.m_entered) {
+        leaveNode_(done.m_node);
+        m_callstack.pop_back();
+      }
+    }
   }
+}
 
-  m_callstack.emplace_back(node);
+bool AstListener::enterNode_(const AstNode& node) {
+  // clang-format off
+  switch (node.m_object->m_type) {
+<ENTER_CASE_STATEMENTS>
+    default: return false;
+  };
+  // clang-format on
+}
+
+void AstListener::leaveNode_(const AstNode& node) {
   // clang-format off
   switch (node.m_object->m_type) {
-<LISTEN_CASE_STATEMENTS>
+<LEAVE_CASE_STATEMENTS>
     default: break;
   };
   // clang-format on
-  m_callstack.pop_back();
 }
 }  // namespace SURELOG
@@ -0,0 +1,266 @@
+/*
+ Copyright 2023 The Surelog Team.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include <Surelog/API/Surelog.h>
+#include <Surelog/CommandLine/CommandLineParser.h>
+#include <Surelog/Common/PlatformFileSystem.h>
+#include <Surelog/Design/VObject.h>
+#include <Surelog/ErrorReporting/ErrorContainer.h>
+#include <Surelog/SourceCompile/AstListener.h>
+#include <Surelog/SourceCompile/SymbolTable.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SURELOG {
+
+namespace fs = std::filesystem;
+
+namespace {
+class TestFileSystem : public PlatformFileSystem {
+ public:
+  explicit TestFileSystem(const fs::path& wd) : PlatformFileSystem(wd) {
+    FileSystem::setInstance(this);
+  }
+};
+
+struct TestNode {
+  VObjectType m_type;
+  unsigned int m_line;
+  unsigned short m_column;
+  RawNodeId m_parent;
+};
+
+// Lays the nodes out the way FileContent does: entry 0 is unused and the
+// root is the last entry. Children are linked in the order they are listed,
+// which doesn't have to be the source order.
+std::vector<VObject> buildTree(const std::vector<TestNode>& nodes) {
+  std::vector<VObject> objects;
+  objects.emplace_back(BadSymbolId, BadPathId, VObjectType::sl_INVALID_, 0, 0,
+                       0, 0);
+  for (const TestNode& node : nodes) {
+    objects.emplace_back(BadSymbolId, BadPathId, node.m_type, node.m_line,
+                         node.m_column, node.m_line, node.m_column,
+                         NodeId(node.m_parent));
+  }
+  objects.emplace_back(BadSymbolId, BadPathId, VObjectType::slTop, 0, 0, 0, 0);
+  const RawNodeId root = objects.size() - 1;
+  for (RawNodeId id = 1; id < root; ++id) {
+    const RawNodeId parentId = nodes[id - 1].m_parent ? nodes[id - 1].m_parent
+                                                      : root;
+    objects[id].m_parent = NodeId(parentId);
+    NodeId* link = &objects[parentId].m_child;
+    while (*link) link = &objects[(RawNodeId)*link].m_sibling;
+    *link = NodeId(id);
+  }
+  return objects;
+}
+
+class TraceListener : public AstListener {
+ public:
+  enum class OnEnter { Nothing, ListenChildren, ListenSiblings };
+
+  explicit TraceListener(OnEnter onModule = OnEnter::Nothing,
+                         OnEnter onPort = OnEnter::Nothing)
+      : m_onModule(onModule), m_onPort(onPort) {}
+
+  void enterModule_declaration(const AstNode& node) final {
+    trace("+M", node);
+    onEnter(m_onModule, node);
+  }
+  void leaveModule_declaration(const AstNode& node) final {
+    trace("-M", node);
+  }
+  void enterPort(const AstNode& node) final {
+    trace("+P", node);
+    onEnter(m_onPort, node);
+  }
+  void leavePort(const AstNode& node) final { trace("-P", node); }
+
+  std::string m_trace;
+
+ private:
+  void trace(std::string_view what, const AstNode& node) {
+    int32_t line = 0;
+    int32_t column = 0;
+    getNodeStartLocation(node, line, column);
+    if (!m_trace.empty()) m_trace.append(" ");
+    m_trace.append(what).append(std::to_string(line));
+  }
+
+  void onEnter(OnEnter action, const AstNode& node) {
+    switch (action) {
+      case OnEnter::ListenChildren:
+        listenChildren(node, false);
+        break;
+      case OnEnter::ListenSiblings:
+        listenSiblings(node, true);
+        break;
+      default:
+        break;
+    }
+  }
+
+  const OnEnter m_onModule;
+  const OnEnter m_onPort;
+};
+
+// Two modules listed out of source order. The first one has three ports,
+// also out of order. The port of the second one is under a node type without
+// callbacks, which is not traversed.
+const std::vector<TestNode> kTree = {
+    {VObjectType::slModule_declaration, 10, 0, 0},  // 1
+    {VObjectType::slPort, 13, 0, 1},                // 2
+    {VObjectType::slPort, 11, 0, 1},                // 3
+    {VObjectType::slPort, 12, 0, 1},                // 4
+    {VObjectType::slModule_declaration, 1, 0, 0},   // 5
+    {VObjectType::slNull_rule, 2, 0, 5},            // 6
+    {VObjectType::slPort, 3, 0, 6},                 // 7
+};
+
+TEST(AstListenerTest, CallbackOrder) {
+  const std::vector<VObject> objects = buildTree(kTree);
+  TraceListener listener;
+  listener.listen(BadPathId, objects.data(), objects.size(), nullptr);
+  EXPECT_EQ(listener.m_trace,
+            "+M1 -M1 +M10 +P11 -P11 +P12 -P12 +P13 -P13 -M10");
+}
+
+TEST(AstListenerTest, ListenChildrenFromEnter) {
+  // Children listened to from the enter callback come in link order and are
+  // not visited again by the walk.
+  const std::vector<VObject> objects = buildTree(kTree);
+  TraceListener listener(TraceListener::OnEnter::ListenChildren);
+  listener.listen(BadPathId, objects.data(), objects.size(), nullptr);
+  EXPECT_EQ(listener.m_trace,
+            "+M1 -M1 +M10 +P13 -P13 +P11 -P11 +P12 -P12 -M10");
+}
+
+TEST(AstListenerTest, ListenSiblingsFromEnter) {
+  // The first port entered listens to the others before it is left itself.
+  const std::vector<VObject> objects = buildTree(kTree);
+  TraceListener listener(TraceListener::OnEnter::Nothing,
+                         TraceListener::OnEnter::ListenSiblings);
+  listener.listen(BadPathId, objects.data(), objects.size(), nullptr);
+  EXPECT_EQ(listener.m_trace,
+            "+M1 -M1 +M10 +P11 +P12 +P13 -P13 -P12 -P11 -M10");
+}
+
+class CountingListener : public AstListener {
+ public:
+  typedef std::map<PathId, int32_t, PathIdLessThanComparer> FileCounts;
+
+  explicit CountingListener(int32_t* clones) : m_clones(clones) {}
+
+  AstListener* clone() const final {
+    if (m_clones == nullptr) return nullptr;
+    ++*m_clones;
+    return new CountingListener(nullptr);
+  }
+  void join(AstListener* worker) final {
+    for (const auto& [fileId, count] :
+         static_cast<CountingListener*>(worker)->m_modules) {
+      EXPECT_EQ(m_modules.count(fileId), 0u) << PathIdPP(fileId);
+      m_modules[fileId] += count;
+    }
+    ++m_joined;
+  }
+
+  void enterSourceFile(PathId fileId) final {
+    m_fileId = fileId;
+    m_modules[fileId];
+  }
+  void enterModule_declaration(const AstNode& node) final {
+    ++m_modules[m_fileId];
+  }
+
+  FileCounts m_modules;
+  int32_t m_joined = 0;
+
+ private:
+  int32_t* const m_clones;
+  PathId m_fileId;
+};
+
+TEST(AstListenerTest, ParallelWalk) {
+  const fs::path kBaseDir = fs::path(testing::TempDir()) / "ast_listener";
+  const fs::path kProgramFile = FileSystem::getProgramPath();
+
+  std::error_code ec;
+  fs::remove_all(kBaseDir, ec);
+  fs::create_directories(kBaseDir, ec);
+
+  std::unique_ptr<FileSystem> fileSystem(new TestFileSystem(kBaseDir));
+  std::unique_ptr<SymbolTable> symbolTable(new SymbolTable);
+  std::unique_ptr<ErrorContainer> errors(new ErrorContainer(symbolTable.get()));
+  std::unique_ptr<CommandLineParser> clp(
+      new CommandLineParser(errors.get(), symbolTable.get(), false, false));
+
+  constexpr int32_t kFileCount = 8;
+  std::vector<std::string> args{kProgramFile.string(), "-nostdout",
+                                "-nobuiltin", "-parse"};
+  for (int32_t i = 0; i < kFileCount; ++i) {
+    const fs::path file = kBaseDir / ("file" + std::to_string(i) + ".sv");
+    const PathId fileId =
+        fileSystem->toPathId(file.string(), symbolTable.get());
+    std::ostream& strm = fileSystem->openForWrite(fileId);
+    EXPECT_TRUE(strm.good());
+    // File i declares i + 1 modules
+    for (int32_t j = 0; j <= i; ++j) {
+      strm << "module m" << i << "_" << j << "(input a);" << std::endl
+           << "endmodule" << std::endl;
+    }
+    fileSystem->close(strm);
+    args.emplace_back(file.string());
+  }
+  args.emplace_back("-o");
+  args.emplace_back((kBaseDir / "out").string());
+  std::vector<const char*> cargs;
+  std::transform(args.begin(), args.end(), std::back_inserter(cargs),
+                 [](const std::string& arg) { return arg.data(); });
+  clp->parseCommandLine(cargs.size(), cargs.data());
+
+  scompiler* compiler = start_compiler(clp.get());
+  ASSERT_NE(compiler, nullptr);
+
+  // Without clone() the walk stays serial
+  CountingListener serial(nullptr);
+  walk_ast(compiler, &serial, 4);
+  EXPECT_EQ(serial.m_modules.size(), static_cast<size_t>(kFileCount));
+  EXPECT_EQ(serial.m_joined, 0);
+
+  int32_t clones = 0;
+  CountingListener parallel(&clones);
+  walk_ast(compiler, &parallel, 4);
+  EXPECT_EQ(clones, 4);
+  EXPECT_EQ(parallel.m_joined, clones);
+  EXPECT_EQ(parallel.m_modules, serial.m_modules);
+
+  int32_t total = 0;
+  for (const auto& [fileId, count] : parallel.m_modules) total += count;
+  EXPECT_EQ(total, kFileCount * (kFileCount + 1) / 2);
+
+  shutdown_compiler(compiler);
+  fs::remove_all(kBaseDir, ec);
+}
+
+}  // namespace
+}  // namespace SURELOG
@@ -27,14 +27,31 @@ namespace SURELOG {
 CompilationUnit::CompilationUnit(bool fileunit)
     : m_fileunit(fileunit), m_inDesignElement(false) {}
 
-MacroInfo* CompilationUnit::getMacroInfo(const std::string& macroName) {
-  MacroStorageRef::iterator itr = m_macros.find(macroName);
+MacroInfo* CompilationUnit::findMacro_(std::string_view macroName) const {
+  MacroStorageRef::const_iterator itr = m_macros.find(macroName);
   if (itr != m_macros.end()) {
     return itr->second.back();
   }
+  if ((m_baseMacros != nullptr) && !m_hideAllBaseMacros) {
+    itr = m_baseMacros->find(macroName);
+    if ((itr != m_baseMacros->end()) &&
+        (m_hiddenBaseMacros.find(macroName) == m_hiddenBaseMacros.end())) {
+      return itr->second.back();
+    }
+  }
   return nullptr;
 }
 
+MacroInfo* CompilationUnit::getMacroInfo(const std::string& macroName) {
+  // Once defined or undefined here, or after `undefineall, the macro no
+  // longer depends on what the files before this one did.
+  if (m_speculative && !m_hideAllBaseMacros &&
+      (m_changedMacros.find(macroName) == m_changedMacros.end())) {
+    m_speculativeLookups.emplace(macroName);
+  }
+  return findMacro_(macroName);
+}
+
 void CompilationUnit::registerMacroInfo(const std::string& macroName,
                                         MacroInfo* macro) {
   MacroStorageRef::iterator itr = m_macros.find(macroName);
@@ -42,6 +59,13 @@ void CompilationUnit::registerMacroInfo(const std::string& macroName,
     itr = m_macros.emplace(macroName, std::vector<MacroInfo*>{}).first;
   }
   itr->second.push_back(macro);
+  if (m_speculative) {
+    m_changedMacros.emplace(macroName);
+    Change& change = m_changes.emplace_back();
+    change.m_kind = Change::Kind::DefineMacro;
+    change.m_macroName = macroName;
+    change.m_macro = macro;
+  }
 }
 
 void CompilationUnit::deleteMacro(const std::string& macroName) {
@@ -49,10 +73,77 @@ void CompilationUnit::deleteMacro(const std::string& macroName) {
   if (itr != m_macros.end()) {
     m_macros.erase(itr);
   }
+  if ((m_baseMacros != nullptr) &&
+      (m_baseMacros->find(macroName) != m_baseMacros->end())) {
+    m_hiddenBaseMacros.emplace(macroName);
+  }
+  if (m_speculative) {
+    m_changedMacros.emplace(macroName);
+    Change& change = m_changes.emplace_back();
+    change.m_kind = Change::Kind::UndefineMacro;
+    change.m_macroName = macroName;
+  }
+}
+
+void CompilationUnit::deleteAllMacros() {
+  m_macros.clear();
+  m_hideAllBaseMacros = true;
+  if (m_speculative) {
+    m_changes.emplace_back().m_kind = Change::Kind::UndefineAllMacros;
+  }
+}
+
+bool CompilationUnit::isSpeculationValid(const CompilationUnit& actual) const {
+  // `timescale and `resetall are checked against the design element state,
+  // the speculation assumes the previous files left no design element open.
+  if (actual.isInDesignElement()) return false;
+  for (const auto& macroName : m_speculativeLookups) {
+    MacroInfo* predicted = nullptr;
+    if (m_baseMacros != nullptr) {
+      MacroStorageRef::const_iterator itr = m_baseMacros->find(macroName);
+      if (itr != m_baseMacros->end()) predicted = itr->second.back();
+    }
+    if (actual.findMacro_(macroName) != predicted) return false;
+  }
+  return true;
+}
+
+void CompilationUnit::replaySpeculation(CompilationUnit* actual) const {
+  for (const Change& change : m_changes) {
+    switch (change.m_kind) {
+      case Change::Kind::DefineMacro:
+        actual->registerMacroInfo(change.m_macroName, change.m_macro);
+        break;
+      case Change::Kind::UndefineMacro:
+        actual->deleteMacro(change.m_macroName);
+        break;
+      case Change::Kind::UndefineAllMacros:
+        actual->deleteAllMacros();
+        break;
+      case Change::Kind::SetCurrentTimeInfo:
+        actual->setCurrentTimeInfo(change.m_timeInfo.m_fileId);
+        break;
+      case Change::Kind::RecordTimeInfo: {
+        TimeInfo info = change.m_timeInfo;
+        actual->recordTimeInfo(info);
+        break;
+      }
+    }
+  }
+  if (m_inDesignElement) {
+    actual->setInDesignElement();
+  } else {
+    actual->unsetInDesignElement();
+  }
 }
 
 void CompilationUnit::recordTimeInfo(TimeInfo& info) {
   m_timeInfo.push_back(info);
+  if (m_speculative) {
+    Change& change = m_changes.emplace_back();
+    change.m_kind = Change::Kind::RecordTimeInfo;
+    change.m_timeInfo = info;
+  }
 }
 
 TimeInfo& CompilationUnit::getTimeInfo(PathId fileId, unsigned int line) {
@@ -91,6 +182,11 @@ VObjectType CompilationUnit::getDefaultNetType(PathId fileId,
 }
 
 void CompilationUnit::setCurrentTimeInfo(PathId fileId) {
+  if (m_speculative) {
+    Change& change = m_changes.emplace_back();
+    change.m_kind = Change::Kind::SetCurrentTimeInfo;
+    change.m_timeInfo.m_fileId = fileId;
+  }
   if (m_timeInfo.empty()) {
     return;
   }
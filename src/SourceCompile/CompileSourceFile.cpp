@@ -26,6 +26,7 @@
 #include <Surelog/ErrorReporting/ErrorContainer.h>
 #include <Surelog/Library/Library.h>
 #include <Surelog/Package/Precompiled.h>
+#include <Surelog/SourceCompile/CompilationUnit.h>
 #include <Surelog/SourceCompile/CompileSourceFile.h>
 #include <Surelog/SourceCompile/Compiler.h>
 #include <Surelog/SourceCompile/ParseFile.h>
@@ -129,12 +130,17 @@ CompileSourceFile::~CompileSourceFile() {
   delete m_pythonListener;
 #endif
   for (auto& entry : m_antlrPpMacroMap) {
-    delete entry.second;
+    delete entry.second.m_handler;
   }
   for (auto& entry : m_antlrPpFileMap) {
     delete entry.second;
   }
+  for (PreprocessFile::AntlrParserHandler* handler : m_retiredMacroHandlers) {
+    delete handler;
+  }
   m_antlrPpMacroMap.clear();
+  m_macroHandlerLru.clear();
+  m_retiredMacroHandlers.clear();
   m_antlrPpFileMap.clear();
 }
 
@@ -234,13 +240,19 @@ bool CompileSourceFile::preprocess_() {
   if (m_commandLineParser->getDebugIncludeFileInfo())
     std::cerr << m_pp->reportIncludeInfo();
 
+  // The cache records the `timescale state of the compilation unit, a
+  // speculative run only knows it once replayed.
+  if (!m_compilationUnit->isSpeculative()) savePreprocessorCache();
+  return true;
+}
+
+void CompileSourceFile::savePreprocessorCache() {
   Precompiled* prec = Precompiled::getSingleton();
   if ((!m_commandLineParser->createCache()) &&
       prec->isFilePrecompiled(m_fileId, getSymbolTable()))
-    return true;
+    return;
 
   m_pp->saveCache();
-  return true;
 }
 
 bool CompileSourceFile::postPreprocess_() {
@@ -289,14 +301,53 @@ bool CompileSourceFile::postPreprocess_() {
   return true;
 }
 
-void CompileSourceFile::registerAntlrPpHandlerForId(
-    SymbolId id, PreprocessFile::AntlrParserHandler* pp) {
-  auto itr = m_antlrPpMacroMap.find(id);
+void CompileSourceFile::registerAntlrPpHandlerForMacro(
+    uint64_t signature, std::string_view body,
+    PreprocessFile::AntlrParserHandler* pp) {
+  auto itr = m_antlrPpMacroMap.find(signature);
   if (itr != m_antlrPpMacroMap.end()) {
-    delete (*itr).second;
+    MacroHandlerEntry& entry = (*itr).second;
+    if (entry.m_handler == pp) return;
+    if (entry.m_handler->m_activeWalks != 0) {
+      // Colliding body still being walked, delete it with the file
+      m_retiredMacroHandlers.push_back(entry.m_handler);
+    } else {
+      delete entry.m_handler;
+    }
+    entry.m_handler = pp;
+    entry.m_body = body;
+    m_macroHandlerLru.splice(m_macroHandlerLru.begin(), m_macroHandlerLru,
+                             entry.m_lruPos);
+    return;
+  }
+  evictMacroHandlers_();
+  m_macroHandlerLru.push_front(signature);
+  MacroHandlerEntry entry;
+  entry.m_body = body;
+  entry.m_handler = pp;
+  entry.m_lruPos = m_macroHandlerLru.begin();
+  m_antlrPpMacroMap.emplace(signature, std::move(entry));
+}
+
+void CompileSourceFile::evictMacroHandlers_() {
+  if (m_antlrPpMacroMap.size() < kMaxMacroHandlers) return;
+  // The Python listeners may still walk the preprocessor trees
+  if (m_commandLineParser->pythonListener() ||
+      m_commandLineParser->pythonEvalScriptPerFile() ||
+      m_commandLineParser->pythonEvalScript())
+    return;
+  auto lruItr = m_macroHandlerLru.end();
+  while ((lruItr != m_macroHandlerLru.begin()) &&
+         (m_antlrPpMacroMap.size() >= kMaxMacroHandlers)) {
+    --lruItr;
+    auto itr = m_antlrPpMacroMap.find(*lruItr);
+    // Handlers of the macros being expanded are still walked
+    if ((*itr).second.m_handler->m_activeWalks != 0) continue;
+    delete (*itr).second.m_handler;
     m_antlrPpMacroMap.erase(itr);
+    lruItr = m_macroHandlerLru.erase(lruItr);
+    m_macroHandlerStats.m_evictions++;
   }
-  m_antlrPpMacroMap.emplace(id, pp);
 }
 
 void CompileSourceFile::registerAntlrPpHandlerForId(
@@ -309,13 +360,17 @@ void CompileSourceFile::registerAntlrPpHandlerForId(
   m_antlrPpFileMap.emplace(id, pp);
 }
 
-PreprocessFile::AntlrParserHandler* CompileSourceFile::getAntlrPpHandlerForId(
-    SymbolId id) {
-  auto itr = m_antlrPpMacroMap.find(id);
-  if (itr != m_antlrPpMacroMap.end()) {
-    PreprocessFile::AntlrParserHandler* ptr = (*itr).second;
-    return ptr;
+PreprocessFile::AntlrParserHandler*
+CompileSourceFile::getAntlrPpHandlerForMacro(uint64_t signature,
+                                             std::string_view body) {
+  auto itr = m_antlrPpMacroMap.find(signature);
+  if ((itr != m_antlrPpMacroMap.end()) && ((*itr).second.m_body == body)) {
+    m_macroHandlerLru.splice(m_macroHandlerLru.begin(), m_macroHandlerLru,
+                             (*itr).second.m_lruPos);
+    m_macroHandlerStats.m_hits++;
+    return (*itr).second.m_handler;
   }
+  m_macroHandlerStats.m_misses++;
   return nullptr;
 }
 
@@ -329,10 +384,31 @@ PreprocessFile::AntlrParserHandler* CompileSourceFile::getAntlrPpHandlerForId(
   return nullptr;
 }
 
+void CompileSourceFile::releaseAntlrPpHandlers() {
+  for (auto& entry : m_antlrPpMacroMap) {
+    delete entry.second.m_handler;
+  }
+  for (auto& entry : m_antlrPpFileMap) {
+    delete entry.second;
+  }
+  for (PreprocessFile::AntlrParserHandler* handler : m_retiredMacroHandlers) {
+    delete handler;
+  }
+  m_antlrPpMacroMap.clear();
+  m_macroHandlerLru.clear();
+  m_retiredMacroHandlers.clear();
+  m_antlrPpFileMap.clear();
+}
+
 void CompileSourceFile::setSymbolTable(SymbolTable* symbols) {
   m_symbolTable = symbols;
 }
 
+void CompileSourceFile::setCompilationUnit(CompilationUnit* compilationUnit) {
+  m_compilationUnit = compilationUnit;
+  if (m_pp != nullptr) m_pp->setCompilationUnit(compilationUnit);
+}
+
 #ifdef SURELOG_WITH_PYTHON
 void CompileSourceFile::setPythonInterp(PyThreadState* interpState) {
   m_interpState = interpState;
@@ -22,6 +22,7 @@
  */
 
 #include <Surelog/API/PythonAPI.h>
+#include <Surelog/Cache/DFACache.h>
 #include <Surelog/CommandLine/CommandLineParser.h>
 #include <Surelog/Common/FileSystem.h>
 #include <Surelog/Config/ConfigSet.h>
@@ -41,10 +42,17 @@
 #include <Surelog/SourceCompile/ParseFile.h>
 #include <Surelog/SourceCompile/SymbolTable.h>
 #include <Surelog/Utils/ContainerUtils.h>
+#include <Surelog/Utils/MemoryUsage.h>
 #include <Surelog/Utils/StringUtils.h>
 #include <Surelog/Utils/Timer.h>
 #include <antlr4-runtime.h>
+#include <parser/SV3_1aLexer.h>
+#include <parser/SV3_1aParser.h>
+#include <parser/SV3_1aPpLexer.h>
+#include <parser/SV3_1aPpParser.h>
 
+#include <atomic>
+#include <cstdlib>
 #include <filesystem>
 #include <thread>
 
@@ -141,8 +149,8 @@ bool Compiler::ppinit_() {
   if (!m_commandLineParser->fileunit()) {
     m_commonCompilationUnit = new CompilationUnit(false);
     if (m_commandLineParser->parseBuiltIn()) {
-      Builtin* builtin = new Builtin(nullptr, nullptr);
-      builtin->addBuiltinMacros(m_commonCompilationUnit);
+      Builtin builtin(nullptr, nullptr);
+      builtin.addBuiltinMacros(m_commonCompilationUnit);
     }
   }
 
@@ -155,8 +163,8 @@ bool Compiler::ppinit_() {
     if (m_commandLineParser->fileunit()) {
       comp_unit = new CompilationUnit(true);
       if (m_commandLineParser->parseBuiltIn()) {
-        Builtin* builtin = new Builtin(nullptr, nullptr);
-        builtin->addBuiltinMacros(comp_unit);
+        Builtin builtin(nullptr, nullptr);
+        builtin.addBuiltinMacros(comp_unit);
       }
       m_compilationUnits.push_back(comp_unit);
       symbols = m_commandLineParser->getSymbolTable()->CreateSnapshot();
@@ -778,6 +786,7 @@ bool Compiler::cleanup_() {
   DeleteContainerPointersAndClear(&m_compilers);
   DeleteContainerPointersAndClear(&m_compilationUnits);
   DeleteContainerPointersAndClear(&m_symbolTables);
+  DeleteContainerPointersAndClear(&m_speculativeSymbolTables);
   DeleteContainerPointersAndClear(&m_errorContainers);
   return true;
 }
@@ -929,27 +938,137 @@ bool Compiler::compileFileSet_(CompileSourceFile::Action action,
   return true;
 }
 
+bool Compiler::preprocessSpeculatively_() {
+  // The speculation starts from the compilation unit ppinit_() created
+  if (!m_commonCompilationUnit->getMacros().empty() ||
+      !m_commonCompilationUnit->getTimeInfo().empty()) {
+    return compileFileSet_(CompileSourceFile::Preprocess, false, m_compilers);
+  }
+
+  const size_t nbFiles = m_compilers.size();
+  std::vector<CompilationUnit*> units(nbFiles);
+  std::vector<ErrorContainer*> errorContainers(nbFiles);
+  for (size_t i = 0; i < nbFiles; i++) {
+    CompileSourceFile* const compiler = m_compilers[i];
+    CompilationUnit* const unit = new CompilationUnit(false);
+    unit->setBaseMacros(m_commonCompilationUnit->getBaseMacros());
+    unit->setSpeculative();
+    m_compilationUnits.push_back(unit);
+    units[i] = unit;
+
+    // Files run concurrently, each one gets its own symbols
+    SymbolTable* const symbols = compiler->getSymbolTable()->CreateSnapshot();
+    m_speculativeSymbolTables.push_back(symbols);
+    ErrorContainer* const errors = new ErrorContainer(symbols);
+    m_errorContainers.push_back(errors);
+    errors->registerCmdLine(m_commandLineParser);
+    errorContainers[i] = compiler->getErrorContainer();
+
+    compiler->setSymbolTable(symbols);
+    compiler->setErrorContainer(errors);
+    compiler->setCompilationUnit(unit);
+  }
+
+  const unsigned short maxThreadCount = m_commandLineParser->getNbMaxTreads();
+  std::vector<char> statuses(nbFiles, 0);
+  std::atomic<size_t> nextFile(0);
+  std::vector<std::thread*> threads;
+  for (unsigned short i = 0; (i < maxThreadCount) && (i < nbFiles); i++) {
+    std::thread* th = new std::thread([&] {
+      for (size_t index = nextFile++; index < nbFiles; index = nextFile++) {
+        statuses[index] =
+            m_compilers[index]->compile(CompileSourceFile::Preprocess);
+      }
+    });
+    threads.push_back(th);
+  }
+  for (auto& t : threads) {
+    t->join();
+  }
+  DeleteContainerPointersAndClear(&threads);
+
+  // Validation, in file order. A file whose macro lookups do not give the
+  // same results against the actual compilation unit is preprocessed again,
+  // serially, by a fresh CompileSourceFile.
+  unsigned int nbReruns = 0;
+  for (size_t i = 0; i < nbFiles; i++) {
+    CompileSourceFile* compiler = m_compilers[i];
+    bool status = statuses[i];
+    if (units[i]->isSpeculationValid(*m_commonCompilationUnit)) {
+      units[i]->replaySpeculation(m_commonCompilationUnit);
+      compiler->setCompilationUnit(m_commonCompilationUnit);
+      if (status && !compiler->getErrorContainer()->hasFatalErrors()) {
+        compiler->savePreprocessorCache();
+      }
+    } else {
+      // The discarded run's preprocessor contents refer to its symbols and
+      // errors, the latter are deleted before parsing
+      m_design->removePPFileContents(compiler->getSymbolTable());
+      CompileSourceFile* const rerun = new CompileSourceFile(
+          compiler->getFileId(), m_commandLineParser, errorContainers[i],
+          this, m_symbolTable, m_commonCompilationUnit,
+          compiler->getLibrary());
+      delete compiler;
+      compiler = rerun;
+      m_compilers[i] = compiler;
+      status = compileOneFile_(compiler, CompileSourceFile::Preprocess);
+      nbReruns++;
+    }
+    m_errors->appendErrors(*compiler->getErrorContainer());
+    m_errors->printMessages(m_commandLineParser->muteStdout());
+    if ((!status) || compiler->getErrorContainer()->hasFatalErrors()) {
+      return false;
+    }
+  }
+
+  if (m_commandLineParser->profile()) {
+    std::cout << "Speculative preprocessing: " << nbReruns << " of " << nbFiles
+              << " files preprocessed again" << std::endl;
+  }
+  return true;
+}
+
 bool Compiler::compile() {
   FileSystem* const fileSystem = FileSystem::getInstance();
   std::string profile;
   Timer tmr;
   Timer tmrTotal;
+  // Include and library directories may have changed since a previous run
+  fileSystem->invalidateLocateCache();
   // Scan the libraries definition
   if (!parseLibrariesDef_()) return false;
 
   if (m_commandLineParser->profile()) {
     std::string msg = "Scan libraries took " +
                       StringUtils::to_string(tmr.elapsed_rounded()) + "s\n";
+    msg += profileStage_("libraries", tmr.elapsed_rounded());
     std::cout << msg << std::endl;
     profile += msg;
     tmr.reset();
   }
 
+  // Warm-start the preprocessor and parser prediction DFAs
+  if (m_commandLineParser->getDfaCacheDirId()) {
+    std::string msg = cacheParserDFA_(false);
+    if (m_commandLineParser->profile()) {
+      std::cout << msg << std::endl;
+      profile += msg;
+    }
+  }
+
   // Preprocess
   ppinit_();
   createMultiProcessPreProcessor_();
-  if (!compileFileSet_(CompileSourceFile::Preprocess,
-                       m_commandLineParser->fileunit(), m_compilers)) {
+  if ((!m_commandLineParser->fileunit()) && m_text.empty() &&
+      (m_compilers.size() > 1) &&
+      (m_commandLineParser->getNbMaxTreads() > 0) &&
+      m_commandLineParser->speculativePreprocess() &&
+      !m_commandLineParser->useTbb() &&
+      !m_commandLineParser->pythonListener() &&
+      !m_commandLineParser->pythonEvalScriptPerFile()) {
+    if (!preprocessSpeculatively_()) return false;
+  } else if (!compileFileSet_(CompileSourceFile::Preprocess,
+                              m_commandLineParser->fileunit(), m_compilers)) {
     return false;
   }
   // Single thread post Preprocess
@@ -960,6 +1079,18 @@ bool Compiler::compile() {
   if (m_commandLineParser->profile()) {
     std::string msg = "Preprocessing took " +
                       StringUtils::to_string(tmr.elapsed_rounded()) + "s\n";
+    msg += profileStage_("preprocess", tmr.elapsed_rounded());
+    CompileSourceFile::MacroHandlerCacheStats macroStats;
+    for (const CompileSourceFile* compiler : m_compilers) {
+      const CompileSourceFile::MacroHandlerCacheStats& stats =
+          compiler->getMacroHandlerCacheStats();
+      macroStats.m_hits += stats.m_hits;
+      macroStats.m_misses += stats.m_misses;
+      macroStats.m_evictions += stats.m_evictions;
+    }
+    StrAppend(&msg, "  Macro parse cache: ", macroStats.m_hits, " hits, ",
+              macroStats.m_misses, " misses, ", macroStats.m_evictions,
+              " evictions\n");
     std::cout << msg << std::endl;
     for (const CompileSourceFile* compiler : m_compilers) {
       msg += compiler->getPreprocessor()->getProfileInfo();
@@ -992,6 +1123,7 @@ bool Compiler::compile() {
   if (m_commandLineParser->profile()) {
     std::string msg =
         "Parsing took " + StringUtils::to_string(tmr.elapsed_rounded()) + "s\n";
+    msg += profileStage_("parse", tmr.elapsed_rounded());
     for (const CompileSourceFile* compilerParent : m_compilersParentFiles) {
       msg += compilerParent->getParser()->getProfileInfo();
     }
@@ -1001,15 +1133,37 @@ bool Compiler::compile() {
 
     std::cout << msg << std::endl;
     profile += msg;
+    writeParserDecisionProfile_();
     tmr.reset();
   }
 
+  // With -mp the files are parsed by subprocesses, this process learned
+  // next to nothing and would overwrite a useful cache
+  if (m_commandLineParser->getDfaCacheDirId() &&
+      (m_commandLineParser->getNbMaxProcesses() == 0)) {
+    std::string msg = cacheParserDFA_(true);
+    if (m_commandLineParser->profile()) {
+      std::cout << msg << std::endl;
+      profile += msg;
+      tmr.reset();
+    }
+  }
+
   // Check Parsing
   CheckCompile* checkComp = new CheckCompile(this);
   bool parseOk = checkComp->check();
   delete checkComp;
   m_errors->printMessages(m_commandLineParser->muteStdout());
 
+  if (m_commandLineParser->profile()) {
+    std::string msg = "Checking took " +
+                      StringUtils::to_string(tmr.elapsed_rounded()) + "s\n";
+    msg += profileStage_("check", tmr.elapsed_rounded());
+    std::cout << msg << std::endl;
+    profile += msg;
+    tmr.reset();
+  }
+
   // Python Listener
   if (parseOk && (m_commandLineParser->pythonListener() ||
                   m_commandLineParser->pythonEvalScriptPerFile())) {
@@ -1023,6 +1177,7 @@ bool Compiler::compile() {
     if (m_commandLineParser->profile()) {
       std::string msg = "Python file processing took " +
                         StringUtils::to_string(tmr.elapsed_rounded()) + "s\n";
+      msg += profileStage_("python_files", tmr.elapsed_rounded());
       std::cout << msg << std::endl;
       profile += msg;
       tmr.reset();
@@ -1038,6 +1193,7 @@ bool Compiler::compile() {
     if (m_commandLineParser->profile()) {
       std::string msg = "Compilation took " +
                         StringUtils::to_string(tmr.elapsed_rounded()) + "s\n";
+      msg += profileStage_("compile", tmr.elapsed_rounded());
       std::cout << msg << std::endl;
       profile += msg;
       tmr.reset();
@@ -1050,6 +1206,7 @@ bool Compiler::compile() {
       if (m_commandLineParser->profile()) {
         std::string msg = "Elaboration took " +
                           StringUtils::to_string(tmr.elapsed_rounded()) + "s\n";
+        msg += profileStage_("elaborate", tmr.elapsed_rounded());
         std::cout << msg << std::endl;
         profile += msg;
         tmr.reset();
@@ -1063,6 +1220,7 @@ bool Compiler::compile() {
           std::string msg = "Python design processing took " +
                             StringUtils::to_string(tmr.elapsed_rounded()) +
                             "s\n";
+          msg += profileStage_("python_design", tmr.elapsed_rounded());
           profile += msg;
           std::cout << msg << std::endl;
           tmr.reset();
@@ -1071,12 +1229,24 @@ bool Compiler::compile() {
       m_errors->printMessages(m_commandLineParser->muteStdout());
     }
 
+    releaseAntlrPpHandlers_();
+
     PathId uhdmFileId = fileSystem->getChild(
         m_commandLineParser->getCompileDirId(), "surelog.uhdm",
         m_compileDesign->getCompiler()->getSymbolTable());
     m_uhdmDesign = m_compileDesign->writeUHDM(uhdmFileId);
     // Do not delete as now UHDM has to live past the compilation step
     // delete compileDesign;
+
+    if (m_commandLineParser->profile()) {
+      std::string msg = "UHDM writing took " +
+                        StringUtils::to_string(tmr.elapsed_rounded()) + "s\n";
+      msg += profileStage_("uhdm", tmr.elapsed_rounded());
+      msg += m_design->getArenaProfileInfo();
+      std::cout << msg << std::endl;
+      profile += msg;
+      tmr.reset();
+    }
   }
   if (m_commandLineParser->profile()) {
     std::string msg = "Total time " +
@@ -1087,6 +1257,7 @@ bool Compiler::compile() {
               std::string("==============\n") + profile + "==============\n";
     std::cout << profile << std::endl;
     m_errors->printToLogFile(profile);
+    writeProfileJson_(tmrTotal.elapsed_rounded());
   }
   return true;
 }
@@ -1115,6 +1286,163 @@ PreprocessFile::AntlrParserHandler* Compiler::getAntlrPpHandlerForId(
   return nullptr;
 }
 
+void Compiler::releaseAntlrPpHandlers_() {
+  if (!m_commandLineParser->boundedMem()) return;
+  // The Python listeners may still walk the preprocessor trees
+  if (m_commandLineParser->pythonListener() ||
+      m_commandLineParser->pythonEvalScriptPerFile() ||
+      m_commandLineParser->pythonEvalScript())
+    return;
+  for (auto& entry : m_antlrPpMap) {
+    delete entry.second;
+  }
+  m_antlrPpMap.clear();
+  for (CompileSourceFile* compiler : m_compilers) {
+    compiler->releaseAntlrPpHandlers();
+  }
+  for (CompileSourceFile* compiler : m_compilersParentFiles) {
+    compiler->releaseAntlrPpHandlers();
+  }
+}
+
+void Compiler::acquireParseSlot() {
+  const unsigned int maxSlots = m_commandLineParser->getMaxTokenizedFiles();
+  if (!m_commandLineParser->boundedMem() || (maxSlots == 0)) return;
+  std::unique_lock<std::mutex> lock(m_parseSlotMutex);
+  m_parseSlotCondition.wait(
+      lock, [this, maxSlots] { return m_parseSlotsInUse < maxSlots; });
+  m_parseSlotsInUse++;
+}
+
+void Compiler::releaseParseSlot() {
+  const unsigned int maxSlots = m_commandLineParser->getMaxTokenizedFiles();
+  if (!m_commandLineParser->boundedMem() || (maxSlots == 0)) return;
+  {
+    std::lock_guard<std::mutex> lock(m_parseSlotMutex);
+    m_parseSlotsInUse--;
+  }
+  m_parseSlotCondition.notify_one();
+}
+
+// The prediction DFA is static to each generated parser class, an instance
+// over an empty stream is enough to reach it.
+template <typename Lexer, typename Parser>
+static bool cacheDFA(DFACache* cache, std::string_view grammar, bool save) {
+  antlr4::ANTLRInputStream input;
+  Lexer lexer(&input);
+  antlr4::CommonTokenStream tokens(&lexer);
+  Parser parser(&tokens);
+  return save ? cache->save(&parser, grammar)
+              : cache->restore(&parser, grammar);
+}
+
+std::string Compiler::cacheParserDFA_(bool save) {
+  if (!m_commandLineParser->getDfaCacheDirId()) return "";
+  DFACache cache(m_commandLineParser, m_symbolTable);
+  std::string msg = save ? "DFA cache saved:" : "DFA cache restored:";
+  cacheDFA<SV3_1aPpLexer, SV3_1aPpParser>(&cache, "SV3_1aPpParser", save);
+  StrAppend(&msg, " SV3_1aPpParser ", cache.getStateCount(), " states,");
+  cacheDFA<SV3_1aLexer, SV3_1aParser>(&cache, "SV3_1aParser", save);
+  StrAppend(&msg, " SV3_1aParser ", cache.getStateCount(), " states\n");
+  return msg;
+}
+
+bool Compiler::writeParserDecisionProfile_() {
+  FileSystem* const fileSystem = FileSystem::getInstance();
+  std::vector<std::string> lines;
+  lines.emplace_back("file,line,decision,rule,event,count");
+  for (CompileSourceFile* compiler : m_compilers) {
+    ParseFile* parser = compiler->getParser();
+    if (parser == nullptr) continue;
+    for (const ParseFile::DecisionProfileInfo& info :
+         parser->getDecisionProfile()) {
+      PathId fileId = compiler->getFileId();
+      unsigned int line = info.m_line;
+      if (line > 0) {
+        fileId = parser->getFileId(line);
+        line = parser->getLineNb(line);
+      }
+      // Paths may hold commas or quotes, quote them (RFC 4180)
+      const std::string path = StringUtils::replaceAll(
+          fileSystem->toPath(fileId), "\"", "\"\"");
+      lines.emplace_back(StrCat("\"", path, "\",", line, ",",
+                                info.m_decision, ",", info.m_rule, ",",
+                                info.m_event, ",", info.m_count));
+    }
+  }
+  PathId fileId = fileSystem->getChild(m_commandLineParser->getCompileDirId(),
+                                       "parser_decisions.csv", m_symbolTable);
+  return fileSystem->writeLines(fileId, lines);
+}
+
+std::string Compiler::profileStage_(std::string_view name, double seconds) {
+  StageProfile stage;
+  stage.m_name = name;
+  stage.m_seconds = seconds;
+  stage.m_peakRss = MemoryUsage::getPeakRss();
+  stage.m_rss = MemoryUsage::getCurrentRss();
+  stage.m_heapInUse = MemoryUsage::getHeapInUse();
+  const uint64_t previousHeap =
+      m_stageProfiles.empty() ? 0 : m_stageProfiles.back().m_heapInUse;
+  stage.m_heapDelta = (int64_t)stage.m_heapInUse - (int64_t)previousHeap;
+  for (const auto& fileContent : m_design->getAllFileContents()) {
+    stage.m_vobjectCount += fileContent.second->getVObjects().size();
+  }
+  stage.m_symbolCount = m_symbolTable->getSymbols().size();
+  unsigned int nbTopLevelModules = 0;
+  unsigned int maxDepth = 0;
+  unsigned int numberOfInstances = 0;
+  unsigned int numberOfLeafInstances = 0;
+  unsigned int nbUndefinedModules = 0;
+  unsigned int nbUndefinedInstances = 0;
+  m_design->reportInstanceTreeStats(nbTopLevelModules, maxDepth,
+                                    numberOfInstances, numberOfLeafInstances,
+                                    nbUndefinedModules, nbUndefinedInstances);
+  stage.m_moduleInstanceCount = numberOfInstances;
+  if (m_compileDesign) {
+    for (const auto& [type, count] :
+         m_compileDesign->getSerializer().ObjectStats()) {
+      stage.m_uhdmObjectCount += count;
+    }
+  }
+
+  constexpr uint64_t kMB = 1024 * 1024;
+  std::string msg =
+      StrCat("  Memory: peak RSS ", stage.m_peakRss / kMB, "MB, RSS ",
+             stage.m_rss / kMB, "MB, heap ", stage.m_heapInUse / kMB, "MB (",
+             (stage.m_heapDelta < 0) ? "-" : "+",
+             std::abs(stage.m_heapDelta) / (int64_t)kMB, "MB)\n");
+  StrAppend(&msg, "  Objects: ", stage.m_vobjectCount, " VObjects, ",
+            stage.m_symbolCount, " symbols, ", stage.m_moduleInstanceCount,
+            " module instances, ", stage.m_uhdmObjectCount,
+            " UHDM objects\n");
+  m_stageProfiles.emplace_back(std::move(stage));
+  return msg;
+}
+
+bool Compiler::writeProfileJson_(double totalSeconds) {
+  FileSystem* const fileSystem = FileSystem::getInstance();
+  std::string json = StrCat("{\n  \"total_seconds\": ", totalSeconds,
+                            ",\n  \"stages\": [");
+  for (size_t i = 0; i < m_stageProfiles.size(); ++i) {
+    const StageProfile& stage = m_stageProfiles[i];
+    StrAppend(&json, (i == 0) ? "\n" : ",\n", "    {\"name\": \"",
+              stage.m_name, "\", \"seconds\": ", stage.m_seconds,
+              ", \"peak_rss\": ", stage.m_peakRss, ", \"rss\": ", stage.m_rss,
+              ", \"heap_in_use\": ", stage.m_heapInUse,
+              ", \"heap_delta\": ", stage.m_heapDelta,
+              ", \"vobjects\": ", stage.m_vobjectCount,
+              ", \"symbols\": ", stage.m_symbolCount,
+              ", \"module_instances\": ", stage.m_moduleInstanceCount,
+              ", \"uhdm_objects\": ", stage.m_uhdmObjectCount, "}");
+  }
+  json += "\n  ]\n}\n";
+  PathId fileId =
+      fileSystem->getSibling(m_commandLineParser->getLogFileId(),
+                             "surelog.profile.json", m_symbolTable);
+  return fileSystem->writeContent(fileId, json);
+}
+
 bool Compiler::parseLibrariesDef_() {
   ParseLibraryDef* libParser = new ParseLibraryDef(
       m_commandLineParser, m_errors, m_symbolTable, m_librarySet, m_configSet);
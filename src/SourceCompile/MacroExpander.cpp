@@ -0,0 +1,518 @@
+/*
+ Copyright 2019 Alain Dargelas
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include <Surelog/ErrorReporting/ErrorContainer.h>
+#include <Surelog/SourceCompile/CompilationUnit.h>
+#include <Surelog/SourceCompile/MacroExpander.h>
+#include <Surelog/SourceCompile/MacroInfo.h>
+#include <Surelog/SourceCompile/PreprocessFile.h>
+#include <Surelog/SourceCompile/SymbolTable.h>
+#include <Surelog/Utils/ParseUtils.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace SURELOG {
+
+namespace {
+bool isIdentifierStart(char c) {
+  return std::isalpha(static_cast<unsigned char>(c)) || (c == '_');
+}
+
+bool isIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || (c == '_') ||
+         (c == '$');
+}
+
+bool isDigit(char c) { return std::isdigit(static_cast<unsigned char>(c)); }
+
+bool isSpace(char c) { return (c == ' ') || (c == '\t'); }
+
+// Backtick keywords of SV3_1aPpLexer.g4, never macro instances
+constexpr std::string_view kDirectives[] = {
+    "define",
+    "celldefine",
+    "endcelldefine",
+    "default_nettype",
+    "undef",
+    "ifdef",
+    "ifndef",
+    "else",
+    "elsif",
+    "elseif",
+    "endif",
+    "include",
+    "pragma",
+    "begin_keywords",
+    "end_keywords",
+    "resetall",
+    "timescale",
+    "unconnected_drive",
+    "nounconnected_drive",
+    "line",
+    "default_decay_time",
+    "default_trireg_strength",
+    "delay_mode_distributed",
+    "delay_mode_path",
+    "delay_mode_unit",
+    "delay_mode_zero",
+    "undefineall",
+    "accelerate",
+    "noaccelerate",
+    "protect",
+    "uselib",
+    "disable_portfaults",
+    "enable_portfaults",
+    "nosuppress_faults",
+    "suppress_faults",
+    "signed",
+    "unsigned",
+    "endprotect",
+    "protected",
+    "endprotected",
+    "expand_vectornets",
+    "noexpand_vectornets",
+    "autoexpand_vectornets",
+    "remove_gatename",
+    "noremove_gatenames",
+    "remove_netname",
+    "noremove_netnames",
+    "__FILE__",
+    "__LINE__",
+};
+
+// Keywords the preprocessor listener tracks design elements with
+constexpr std::string_view kDesignElementKeywords[] = {
+    "module",     "endmodule",    "interface", "endinterface",
+    "program",    "endprogram",   "primivite", "endprimitive",
+    "package",    "endpackage",   "checker",   "endchecker",
+    "config",     "endconfig",
+};
+
+template <size_t N>
+bool isOneOf(std::string_view name, const std::string_view (&list)[N]) {
+  return std::find(std::begin(list), std::end(list), name) != std::end(list);
+}
+
+// True if a TIMESCALE token (ie: 1ns/1ps) starts with the digits at pos
+bool isTimescale(std::string_view body, size_t pos) {
+  const size_t size = body.size();
+  while ((pos < size) && isDigit(body[pos])) ++pos;
+  while ((pos < size) && isSpace(body[pos])) ++pos;
+  if ((pos < size) && std::strchr("munpf", body[pos]) && (body[pos] != 0) &&
+      (pos + 1 < size) && (body[pos + 1] == 's')) {
+    pos += 2;
+  } else if ((pos < size) && (body[pos] == 's')) {
+    ++pos;
+  } else {
+    return false;
+  }
+  while ((pos < size) && isSpace(body[pos])) ++pos;
+  return (pos < size) && (body[pos] == '/');
+}
+
+// Returns the length of the base specifier ('h, 'sb, ...) starting at pos
+size_t baseLength(std::string_view body, size_t pos) {
+  if ((pos >= body.size()) || (body[pos] != '\'')) return 0;
+  size_t length = 1;
+  if ((pos + length < body.size()) &&
+      ((body[pos + length] == 's') || (body[pos + length] == 'S'))) {
+    ++length;
+  }
+  if ((pos + length < body.size()) &&
+      std::strchr("dDbBoOhH", body[pos + length]) &&
+      (body[pos + length] != 0)) {
+    return length + 1;
+  }
+  return 0;
+}
+
+bool isBasedValueChar(char c) {
+  return std::isxdigit(static_cast<unsigned char>(c)) || (c == '_') ||
+         (c == ' ') || (c == 'x') || (c == 'X') || (c == 'z') || (c == 'Z') ||
+         (c == '?');
+}
+
+// Identifiers outside of strings that the lexer turns into keywords
+bool hasDesignElementKeyword(std::string_view body) {
+  const size_t size = body.size();
+  size_t pos = 0;
+  while (pos < size) {
+    const char c = body[pos];
+    if (c == '"') {
+      pos = body.find('"', pos + 1);
+      if (pos == std::string_view::npos) return false;
+      ++pos;
+    } else if (isIdentifierStart(c)) {
+      const size_t start = pos;
+      while ((pos < size) && isIdentifierChar(body[pos])) ++pos;
+      if (((start == 0) || (body[start - 1] != '`')) &&
+          isOneOf(body.substr(start, pos - start), kDesignElementKeywords)) {
+        return true;
+      }
+    } else {
+      ++pos;
+    }
+  }
+  return false;
+}
+
+// Scans a string literal starting at pos, false if the preprocessor would
+// have to look inside it (macro instance) or if it is unterminated.
+bool scanString(std::string_view body, size_t& pos) {
+  for (size_t end = pos + 1; end < body.size(); ++end) {
+    const char c = body[end];
+    if (c == '"') {
+      pos = end + 1;
+      return true;
+    }
+    if ((c == '\n') || (c == '\r') || (c == '`')) return false;
+  }
+  return false;
+}
+}  // namespace
+
+void MacroExpander::appendText_(std::string_view text) {
+  if (m_segments.empty() || (m_segments.back().m_kind != Segment::Text)) {
+    m_segments.emplace_back();
+  }
+  m_segments.back().m_text.append(text);
+}
+
+bool MacroExpander::tokenize(std::string_view body) {
+  m_segments.clear();
+  // Escaped identifiers, escaped CRs and comments all have listener side
+  // effects, leave them to the preprocessor grammar.
+  if ((body.find('\\') != std::string_view::npos) ||
+      (body.find("//") != std::string_view::npos) ||
+      (body.find("/*") != std::string_view::npos) ||
+      hasDesignElementKeyword(body)) {
+    return false;
+  }
+
+  const size_t size = body.size();
+  int line = 1;
+  size_t lineStart = 0;
+  size_t located = 0;
+  size_t pos = 0;
+  while (pos < size) {
+    const char c = body[pos];
+    if (c == '`') {
+      if ((pos + 1 < size) && (body[pos + 1] == '`')) {
+        // TICK_VARIABLE (``name``) or TICK_TICK, plain text either way
+        size_t end = pos + 2;
+        while ((end < size) && isIdentifierChar(body[end]) &&
+               (body[end] != '$')) {
+          ++end;
+        }
+        if ((end > pos + 2) && (body.substr(end, 2) == "``")) {
+          end += 2;
+        } else {
+          end = pos + 2;
+        }
+        appendText_(body.substr(pos, end - pos));
+        pos = end;
+        continue;
+      }
+      if ((pos + 1 < size) && (body[pos + 1] == '"')) {
+        appendText_(body.substr(pos, 2));
+        pos += 2;
+        continue;
+      }
+      if ((pos + 1 >= size) || !isIdentifierStart(body[pos + 1])) {
+        return false;
+      }
+      size_t end = pos + 2;
+      while ((end < size) && isIdentifierChar(body[end])) ++end;
+      const std::string_view name = body.substr(pos + 1, end - pos - 1);
+      if (isOneOf(name, kDirectives)) return false;
+      const MacroInfo* const info =
+          m_pp->getCompilationUnit()->getMacroInfo(std::string(name));
+      if (info == nullptr) return false;
+
+      for (; located < pos; ++located) {
+        if (body[located] == '\n') {
+          ++line;
+          lineStart = located + 1;
+        }
+      }
+      Segment segment;
+      segment.m_text = name;
+      segment.m_line = line;
+      segment.m_column = pos - lineStart + 1;
+      segment.m_endColumn = segment.m_column + (end - pos);
+      size_t next = end;
+      while ((next < size) && isSpace(body[next])) ++next;
+      if ((next < size) && (body[next] == '(')) {
+        segment.m_kind = Segment::MacroWithArgs;
+        pos = next + 1;
+        if (!tokenizeArguments_(body, pos, segment)) return false;
+      } else {
+        if (info->m_type == MacroInfo::WITH_ARGS) return false;
+        segment.m_kind = Segment::MacroNoArgs;
+        pos = end;
+      }
+      m_segments.emplace_back(std::move(segment));
+    } else if (c == '"') {
+      const size_t start = pos;
+      if (!scanString(body, pos)) return false;
+      appendText_(body.substr(start, pos - start));
+    } else if (isIdentifierStart(c)) {
+      const size_t start = pos;
+      while ((pos < size) && isIdentifierChar(body[pos])) ++pos;
+      appendText_(body.substr(start, pos - start));
+    } else if (isDigit(c) || (c == '\'')) {
+      if (!tokenizeNumber_(body, pos)) return false;
+    } else if (c == '#') {
+      // Pound_delay and Pound_Pound_delay, kept as is
+      size_t end = pos + 1;
+      if ((end < size) && (body[end] == '#')) ++end;
+      while ((end < size) && (body[end] == ' ')) ++end;
+      if ((end < size) && isDigit(body[end])) {
+        while ((end < size) &&
+               (isDigit(body[end]) || (body[end] == '_') ||
+                (body[end] == '.'))) {
+          ++end;
+        }
+      } else {
+        end = pos + 1;
+      }
+      appendText_(body.substr(pos, end - pos));
+      pos = end;
+    } else {
+      appendText_(body.substr(pos, 1));
+      ++pos;
+    }
+  }
+  return true;
+}
+
+bool MacroExpander::tokenizeNumber_(std::string_view body, size_t& pos) {
+  const size_t size = body.size();
+  size_t baseStart = pos;
+  if (body[pos] == '\'') {
+    if (baseLength(body, pos) == 0) {
+      appendText_(body.substr(pos, 1));
+      ++pos;
+      return true;
+    }
+  } else {
+    if (isTimescale(body, pos)) return false;
+    size_t digitsEnd = pos;
+    while ((digitsEnd < size) && isDigit(body[digitsEnd])) ++digitsEnd;
+    if ((digitsEnd + 1 < size) && (body[digitsEnd] == '.') &&
+        isDigit(body[digitsEnd + 1])) {
+      // Fixed_point_number
+      size_t end = digitsEnd + 1;
+      while ((end < size) && isDigit(body[end])) ++end;
+      appendText_(body.substr(pos, end - pos));
+      pos = end;
+      return true;
+    }
+    size_t sizeEnd = digitsEnd;
+    while ((sizeEnd < size) &&
+           (isDigit(body[sizeEnd]) || (body[sizeEnd] == '_'))) {
+      ++sizeEnd;
+    }
+    baseStart = sizeEnd;
+    while ((baseStart < size) && (body[baseStart] == ' ')) ++baseStart;
+    if ((body[pos] == '0') || (baseLength(body, baseStart) == 0)) {
+      // Unsigned_number, the listener drops the spaces it swallowed except
+      // for a trailing one.
+      size_t end = pos + 1;
+      while ((end < size) &&
+             (isDigit(body[end]) || (body[end] == '_') || (body[end] == ' '))) {
+        ++end;
+      }
+      std::string text;
+      for (size_t i = pos; i < end; ++i) {
+        if ((body[i] == ' ') && (i + 1 != end)) continue;
+        text += body[i];
+      }
+      appendText_(text);
+      pos = end;
+      return true;
+    }
+    if (baseStart != sizeEnd) return false;
+  }
+  // Based number, only taken as is when the listener would not rewrite it:
+  // at most one space, swallowed at its very end.
+  size_t end = baseStart + baseLength(body, baseStart);
+  while ((end < size) && isBasedValueChar(body[end])) ++end;
+  const size_t space = body.find(' ', pos);
+  if ((space < end) && (space + 1 != end)) return false;
+  appendText_(body.substr(pos, end - pos));
+  pos = end;
+  return true;
+}
+
+bool MacroExpander::tokenizeArguments_(std::string_view body, size_t& pos,
+                                       Segment& segment) {
+  // Token texts as the macro_actual_args children would have them, only
+  // the commas and the runs of spaces matter to tokenizeAtComma.
+  const size_t size = body.size();
+  const size_t start = pos;
+  std::vector<std::string> tokens;
+  while (true) {
+    if (pos >= size) return false;
+    const char c = body[pos];
+    if (c == ')') break;
+    if (c == '`') return false;
+    const size_t tokenStart = pos;
+    if (isSpace(c)) {
+      while ((pos < size) && isSpace(body[pos])) ++pos;
+    } else if (c == '"') {
+      if (!scanString(body, pos)) return false;
+    } else if ((c == '(') || (c == '{') || (c == '[')) {
+      std::string closers;
+      do {
+        const char g = body[pos];
+        if (g == '"') {
+          if (!scanString(body, pos)) return false;
+          continue;
+        }
+        if (g == '(') {
+          closers.push_back(')');
+        } else if (g == '{') {
+          closers.push_back('}');
+        } else if (g == '[') {
+          closers.push_back(']');
+        } else if ((g == ')') || (g == '}') || (g == ']')) {
+          if (closers.back() != g) return false;
+          closers.pop_back();
+        } else if (g == '`') {
+          return false;
+        }
+        ++pos;
+      } while (!closers.empty() && (pos < size));
+      if (!closers.empty()) return false;
+    } else if ((c == '}') || (c == ']')) {
+      return false;
+    } else if (isIdentifierStart(c)) {
+      while ((pos < size) && isIdentifierChar(body[pos])) ++pos;
+    } else {
+      ++pos;
+    }
+    tokens.emplace_back(body.substr(tokenStart, pos - tokenStart));
+  }
+  ParseUtils::tokenizeAtComma(segment.m_arguments, tokens);
+  segment.m_nbCRinArgs = std::count(body.begin() + start, body.begin() + pos,
+                                    '\n');
+  ++pos;  // )
+  return true;
+}
+
+void MacroExpander::expand() {
+  m_pp->getCompilationUnit()->setCurrentTimeInfo(m_pp->getFileId(0));
+  for (const Segment& segment : m_segments) {
+    if (segment.m_kind == Segment::Text) {
+      m_pp->append(segment.m_text);
+    } else {
+      expandMacro_(segment);
+    }
+  }
+}
+
+// Mirrors SV3_1aPpTreeShapeListener::enterMacroInstanceWithArgs and
+// enterMacroInstanceNoArgs for a macro body PreprocessFile, which always
+// filters `line information.
+void MacroExpander::expandMacro_(const Segment& segment) {
+  PreprocessFile* const sourceFile = m_pp->getSourceFile();
+  const bool withArgs = (segment.m_kind == Segment::MacroWithArgs);
+  const std::string& macroName = segment.m_text;
+  std::vector<std::string> actualArgs = segment.m_arguments;
+  std::string macroBody;
+  int openingIndex = -1;
+  MacroInfo* macroInf = m_pp->getMacro(macroName);
+  if (macroInf) {
+    unsigned int lineSum = m_pp->getSumLineCount() + 1;
+    openingIndex = sourceFile->addIncludeFileInfo(
+        IncludeFileInfo::Context::MACRO, macroInf->m_startLine, BadSymbolId,
+        macroInf->m_fileId, lineSum, segment.m_column, lineSum,
+        segment.m_endColumn, IncludeFileInfo::Action::PUSH);
+    macroBody = m_pp->getMacro(macroName, actualArgs, m_pp, segment.m_line,
+                               sourceFile->m_loopChecker, m_pp->m_instructions,
+                               macroInf->m_startLine, macroInf->m_fileId);
+  } else {
+    macroBody = m_pp->getMacro(macroName, actualArgs, m_pp, segment.m_line,
+                               sourceFile->m_loopChecker, m_pp->m_instructions);
+  }
+  if (!withArgs && macroBody.empty() &&
+      m_pp->m_instructions.m_mark_empty_macro) {
+    macroBody = SymbolTable::getEmptyMacroMarker();
+  }
+  if (macroBody == PreprocessFile::MacroNotDefined) {
+    macroBody += ":" + macroName + "!!! ";
+    if (!m_pp->m_instructions.m_mute) {
+      const SymbolId nameId = m_pp->registerSymbol(macroName);
+      if (m_pp->getMacroInfo()) {
+        Location loc(m_pp->getMacroInfo()->m_fileId,
+                     m_pp->getMacroInfo()->m_startLine + segment.m_line - 1,
+                     segment.m_column, nameId);
+        Location extraLoc(m_pp->getIncluderFileId(m_pp->getIncluderLine()),
+                          m_pp->getIncluderLine(), 0);
+        Error err(ErrorDefinition::PP_UNKOWN_MACRO, loc, extraLoc);
+        m_pp->addError(err);
+      } else {
+        Location loc(m_pp->getFileId(segment.m_line),
+                     m_pp->getLineNb(segment.m_line), segment.m_column,
+                     nameId);
+        Error err(ErrorDefinition::PP_UNKOWN_MACRO, loc);
+        m_pp->addError(err);
+      }
+    }
+  }
+  const bool emptyMacroBody = macroBody.empty();
+  if (withArgs && emptyMacroBody) {
+    macroBody.append(segment.m_nbCRinArgs, '\n');
+  }
+  m_pp->append(macroBody);
+
+  if (openingIndex < 0) return;
+  PathId fileId;
+  unsigned int line = 0;
+  if (m_pp->getEmbeddedMacroCallFile()) {
+    fileId = m_pp->getEmbeddedMacroCallFile();
+    line = m_pp->getEmbeddedMacroCallLine() + segment.m_line;
+  } else {
+    fileId = m_pp->getFileId(segment.m_line);
+    line = segment.m_line;
+  }
+  unsigned int lineSum = m_pp->getSumLineCount() + 1;
+  int closingIndex = -1;
+  if (withArgs) {
+    if (emptyMacroBody) {
+      lineSum -= segment.m_nbCRinArgs;
+    } else {
+      line += segment.m_nbCRinArgs;
+    }
+    closingIndex = sourceFile->addIncludeFileInfo(
+        IncludeFileInfo::Context::MACRO, line, BadSymbolId, fileId, lineSum,
+        segment.m_column, lineSum, segment.m_endColumn,
+        IncludeFileInfo::Action::POP, openingIndex, 0);
+  } else if (std::count(macroBody.begin(), macroBody.end(), '\n')) {
+    closingIndex = sourceFile->addIncludeFileInfo(
+        IncludeFileInfo::Context::MACRO, line, BadSymbolId, fileId, lineSum,
+        segment.m_column, lineSum, segment.m_endColumn,
+        IncludeFileInfo::Action::POP, openingIndex, 0);
+  } else {
+    return;
+  }
+  sourceFile->getIncludeFileInfo(openingIndex).m_indexClosing = closingIndex;
+}
+
+}  // namespace SURELOG
@@ -22,8 +22,106 @@
  */
 
 #include <Surelog/SourceCompile/MacroInfo.h>
+#include <Surelog/Utils/StringUtils.h>
+
+#include <algorithm>
+#include <limits>
 
 namespace SURELOG {
+
+namespace {
+// Calls f with each body token once the escapes that do not depend on the
+// actual arguments are expanded. Expanding again leaves the tokens
+// unchanged, tokens restored from the cache can go through here a second
+// time.
+template <typename F>
+void forEachExpandedToken(const std::vector<std::string>& tokens, F f) {
+  for (const std::string& tok : tokens) {
+    if (tok == "``_``") {
+      f("``");
+      f("_");
+      f("``");
+    } else if (tok == "`\"") {
+      f("\"");
+    } else if (tok == "`\\`\"") {
+      f("\\\"");
+    } else {
+      f(tok);
+    }
+  }
+}
+
+std::string joinTokens(const std::vector<std::string>& tokens) {
+  std::string body;
+  forEachExpandedToken(tokens,
+                       [&body](std::string_view tok) { body.append(tok); });
+  return body;
+}
+
+std::vector<uint32_t> getTokenEnds(const std::vector<std::string>& tokens) {
+  std::vector<uint32_t> ends;
+  ends.reserve(tokens.size());
+  uint32_t end = 0;
+  forEachExpandedToken(tokens, [&](std::string_view tok) {
+    end += tok.size();
+    ends.push_back(end);
+  });
+  return ends;
+}
+
+std::vector<MacroInfo::Formal> splitFormals(
+    const std::vector<std::string>& arguments) {
+  auto removeBlanks = [](std::string_view text) {
+    std::string result(text);
+    result.erase(
+        std::remove_if(result.begin(), result.end(),
+                       [](char c) { return (c == ' ') || (c == '\t'); }),
+        result.end());
+    return result;
+  };
+  std::vector<MacroInfo::Formal> formals;
+  formals.reserve(arguments.size());
+  for (const std::string& argument : arguments) {
+    std::vector<std::string_view> nameDefault;
+    StringUtils::tokenize(argument, "=", nameDefault);
+    MacroInfo::Formal& formal = formals.emplace_back();
+    if (!nameDefault.empty()) formal.m_name = removeBlanks(nameDefault[0]);
+    if (nameDefault.size() == 2) {
+      formal.m_default = removeBlanks(nameDefault[1]);
+      formal.m_hasDefault = true;
+    }
+  }
+  return formals;
+}
+
+bool isMultiLine(std::string_view body,
+                 const std::vector<MacroInfo::Formal>& formals) {
+  if (body.find('\n') != std::string_view::npos) return true;
+  return std::any_of(formals.begin(), formals.end(),
+                     [](const MacroInfo::Formal& formal) {
+                       return formal.m_default.find('\n') != std::string::npos;
+                     });
+}
+
+// True if the argument substitution for formal compares text against value:
+// formal, `formal, ``formal`` or formal``.
+bool isPatternOf(std::string_view value, std::string_view formal) {
+  const size_t size = formal.size();
+  if (value.size() == size) return value == formal;
+  if (value.size() == size + 1) {
+    return (value.front() == '`') && (value.substr(1) == formal);
+  }
+  if (value.size() == size + 2) {
+    return (value.substr(size) == "``") && (value.substr(0, size) == formal);
+  }
+  if (value.size() == size + 4) {
+    return (value.substr(0, 2) == "``") && (value.substr(size + 2) == "``") &&
+           (value.substr(2, size) == formal);
+  }
+  return false;
+}
+}  // namespace
+
 MacroInfo::MacroInfo(std::string_view name, int type, PathId fileId,
                      unsigned int startLine, unsigned short int startColumn,
                      unsigned int endLine, unsigned short int endColumn,
@@ -36,6 +134,192 @@ MacroInfo::MacroInfo(std::string_view name, int type, PathId fileId,
       m_startColumn(startColumn),
       m_endLine(endLine),
       m_endColumn(endColumn),
-      m_arguments(arguments),
-      m_tokens(tokens) {}
+      m_formals(splitFormals(arguments)),
+      m_body(joinTokens(tokens)),
+      m_tokenEnds(getTokenEnds(tokens)),
+      m_multiLine(isMultiLine(m_body, m_formals)) {
+  m_resolved = resolveFormals_();
+}
+
+std::vector<std::string> MacroInfo::getArguments() const {
+  std::vector<std::string> arguments;
+  arguments.reserve(m_formals.size());
+  for (const Formal& formal : m_formals) {
+    arguments.emplace_back(formal.m_hasDefault
+                               ? StrCat(formal.m_name, "=", formal.m_default)
+                               : formal.m_name);
+  }
+  return arguments;
+}
+
+std::vector<std::string> MacroInfo::getTokens() const {
+  std::vector<std::string> tokens;
+  tokens.reserve(m_tokenEnds.size());
+  uint32_t start = 0;
+  for (uint32_t end : m_tokenEnds) {
+    tokens.emplace_back(m_body, start, end - start);
+    start = end;
+  }
+  return tokens;
+}
+
+// Runs the token replacements of substituteTokens_() once on the body with
+// inert placeholders for the values. As long as no value can be mistaken
+// for a token the replacements look for (see isInert_()), the values end up
+// at the same places whatever they are.
+bool MacroInfo::resolveFormals_() {
+  if (m_formals.size() >
+      static_cast<size_t>(std::numeric_limits<int16_t>::max())) {
+    return false;
+  }
+  std::vector<Piece> slots;
+  slots.reserve(m_tokenEnds.size());
+  uint32_t start = 0;
+  for (uint32_t end : m_tokenEnds) {
+    Piece& slot = slots.emplace_back();
+    slot.m_offset = start;
+    slot.m_length = end - start;
+    start = end;
+  }
+  const std::string_view body = m_body;
+  auto matches = [body](const Piece& slot, std::string_view text) {
+    return (slot.m_formal < 0) &&
+           (body.substr(slot.m_offset, slot.m_length) == text);
+  };
+  // The two StringUtils::replaceInTokenVector overloads, on slots
+  auto replaceSequence = [&](const std::vector<std::string_view>& pattern,
+                             int16_t formal) {
+    bool more = true;
+    while (more) {
+      more = false;
+      uint32_t patternIndex = 0;
+      for (auto itr = slots.begin(); itr != slots.end(); itr++) {
+        if (patternIndex > 0 && !matches(*itr, pattern[patternIndex]))
+          patternIndex = 0;
+        if (matches(*itr, pattern[patternIndex])) {
+          patternIndex++;
+          if (patternIndex == pattern.size()) {
+            *itr = Piece();
+            itr->m_formal = formal;
+            patternIndex = 0;
+            itr = slots.erase(itr - (pattern.size() - 1), itr);
+            more = true;
+          }
+        }
+      }
+    }
+  };
+  auto replaceToken = [&](std::string_view pattern, int16_t formal) {
+    const size_t size = slots.size();
+    for (size_t i = 0; i < size; i++) {
+      if (matches(slots[i], pattern)) {
+        const bool surrounded_by_quotes =
+            (i > 0 && matches(slots[i - 1], "\"")) &&
+            ((i < size - 1) && matches(slots[i + 1], "\""));
+        slots[i] = Piece();
+        slots[i].m_formal = formal;
+        slots[i].m_removeLF = surrounded_by_quotes;
+      }
+    }
+  };
+
+  for (const Formal& formal : m_formals) {
+    if (formal.m_name.empty()) return false;
+    // `formal is only replaced for actual arguments
+    const std::string prefixed = StrCat("`", formal.m_name);
+    if (std::any_of(slots.begin(), slots.end(),
+                    [&](const Piece& slot) { return matches(slot, prefixed); }))
+      return false;
+  }
+  for (size_t i = 0; i < m_formals.size(); i++) {
+    const std::string_view name = m_formals[i].m_name;
+    const int16_t formal = static_cast<int16_t>(i);
+    replaceSequence({"``", name, "``"}, formal);
+    replaceToken(StrCat("``", name, "``"), formal);
+    replaceSequence({name, "``"}, formal);
+    replaceSequence({"``", name}, formal);
+    replaceSequence({name, " ", "``"}, formal);
+    replaceToken(StrCat(name, "``"), formal);
+    replaceToken(name, formal);
+  }
+
+  for (const Piece& slot : slots) {
+    if (slot.m_formal < 0) {
+      if (slot.m_length == 0) continue;
+      if (!m_pieces.empty() && (m_pieces.back().m_formal < 0) &&
+          (m_pieces.back().m_offset + m_pieces.back().m_length ==
+           slot.m_offset)) {
+        m_pieces.back().m_length += slot.m_length;
+        continue;
+      }
+    }
+    m_pieces.push_back(slot);
+  }
+  return true;
+}
+
+// False if a value could be taken for a token by the replacements that
+// come after it is put in.
+bool MacroInfo::isInert_(const std::vector<std::string_view>& values) const {
+  for (size_t i = 0; i < values.size(); i++) {
+    const std::string_view value = values[i];
+    if ((value == "``") || (value == " ") || (value == "\"")) return false;
+    for (size_t j = i; j < m_formals.size(); j++) {
+      if (isPatternOf(value, m_formals[j].m_name)) return false;
+    }
+  }
+  return true;
+}
+
+std::string MacroInfo::substitute(const std::vector<std::string_view>& values,
+                                  const std::vector<bool>& actual) const {
+  if (!m_resolved || !isInert_(values)) {
+    return substituteTokens_(values, actual);
+  }
+  size_t size = m_body.size();
+  for (std::string_view value : values) size += value.size();
+  std::string body;
+  body.reserve(size);
+  for (const Piece& piece : m_pieces) {
+    if (piece.m_formal < 0) {
+      body.append(m_body, piece.m_offset, piece.m_length);
+    } else if (piece.m_removeLF) {
+      body.append(StringUtils::removeLF(values[piece.m_formal]));
+    } else {
+      body.append(values[piece.m_formal]);
+    }
+  }
+  return body;
+}
+
+std::string MacroInfo::substituteTokens_(
+    const std::vector<std::string_view>& values,
+    const std::vector<bool>& actual) const {
+  std::vector<std::string> body_tokens = getTokens();
+  for (size_t i = 0; i < m_formals.size(); i++) {
+    const std::string& formal = m_formals[i].m_name;
+    const std::string_view value = values[i];
+    if (actual[i]) {
+      const std::string pattern = "`" + formal;
+      StringUtils::replaceInTokenVector(body_tokens, {"``", pattern, "``"},
+                                        StrCat("`", value));
+    }
+    StringUtils::replaceInTokenVector(body_tokens, {"``", formal, "``"},
+                                      value);
+    StringUtils::replaceInTokenVector(body_tokens, "``" + formal + "``",
+                                      value);
+    StringUtils::replaceInTokenVector(body_tokens, {formal, "``"}, value);
+    StringUtils::replaceInTokenVector(body_tokens, {"``", formal}, value);
+    StringUtils::replaceInTokenVector(body_tokens, {formal, " ", "``"}, value);
+    StringUtils::replaceInTokenVector(body_tokens, formal + "``", value);
+    StringUtils::replaceInTokenVector(body_tokens, formal, value);
+  }
+  std::string body;
+  body.reserve(m_body.size());
+  for (const auto& token : body_tokens) {
+    body += token;
+  }
+  return body;
+}
+
 }  // namespace SURELOG
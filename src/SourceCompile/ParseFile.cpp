@@ -30,6 +30,7 @@
 #include <Surelog/SourceCompile/AntlrParserErrorListener.h>
 #include <Surelog/SourceCompile/AntlrParserHandler.h>
 #include <Surelog/SourceCompile/CompileSourceFile.h>
+#include <Surelog/SourceCompile/Compiler.h>
 #include <Surelog/SourceCompile/ParseFile.h>
 #include <Surelog/SourceCompile/SV3_1aTreeShapeListener.h>
 #include <Surelog/SourceCompile/SymbolTable.h>
@@ -40,6 +41,94 @@
 #include <parser/SV3_1aParser.h>
 
 namespace SURELOG {
+
+// Bails out of the parse like antlr4::BailErrorStrategy, but remembers the
+// offending decision and the top level description being parsed, so that
+// only that description has to be re-parsed in LL mode.
+class SllBailErrorStrategy final : public antlr4::BailErrorStrategy {
+ public:
+  void recover(antlr4::Parser* recognizer, std::exception_ptr e) override {
+    size_t state = recognizer->getState();
+    try {
+      std::rethrow_exception(e);
+    } catch (antlr4::RecognitionException& ex) {
+      state = ex.getOffendingState();
+    } catch (...) {
+    }
+    record_(recognizer, state);
+    antlr4::BailErrorStrategy::recover(recognizer, e);
+  }
+
+  antlr4::Token* recoverInline(antlr4::Parser* recognizer) override {
+    record_(recognizer, recognizer->getState());
+    return antlr4::BailErrorStrategy::recoverInline(recognizer);
+  }
+
+  void clear() {
+    m_decision = -1;
+    m_rule.clear();
+    m_line = 0;
+    m_description = nullptr;
+    m_sourceText = nullptr;
+    m_topLevelRule = nullptr;
+  }
+
+  int m_decision = -1;
+  std::string m_rule;
+  unsigned int m_line = 0;
+  SV3_1aParser::DescriptionContext* m_description = nullptr;
+  SV3_1aParser::Source_textContext* m_sourceText = nullptr;
+  SV3_1aParser::Top_level_ruleContext* m_topLevelRule = nullptr;
+
+ private:
+  void record_(antlr4::Parser* recognizer, size_t state) {
+    clear();
+    const antlr4::atn::ATN& atn = recognizer->getATN();
+    if (state < atn.states.size()) {
+      if (const antlr4::atn::DecisionState* ds =
+              dynamic_cast<const antlr4::atn::DecisionState*>(
+                  atn.states[state])) {
+        m_decision = ds->decision;
+      }
+    }
+    antlr4::ParserRuleContext* ctx = recognizer->getContext();
+    if (ctx != nullptr) m_rule = recognizer->getRuleNames()[ctx->getRuleIndex()];
+    if (antlr4::Token* token = recognizer->getCurrentToken()) {
+      m_line = token->getLine();
+    }
+    for (; ctx != nullptr;
+         ctx = dynamic_cast<antlr4::ParserRuleContext*>(ctx->parent)) {
+      antlr4::ParserRuleContext* parent =
+          dynamic_cast<antlr4::ParserRuleContext*>(ctx->parent);
+      if ((ctx->getRuleIndex() == SV3_1aParser::RuleDescription) &&
+          (parent != nullptr) &&
+          (parent->getRuleIndex() == SV3_1aParser::RuleSource_text)) {
+        m_description = static_cast<SV3_1aParser::DescriptionContext*>(ctx);
+        m_sourceText = static_cast<SV3_1aParser::Source_textContext*>(parent);
+        m_topLevelRule = dynamic_cast<SV3_1aParser::Top_level_ruleContext*>(
+            parent->parent);
+        break;
+      }
+    }
+  }
+};
+
+// Parser::reset() also deletes every context the parser allocated so far,
+// the partially built tree included. This only resets the parsing state, so
+// that a rule can be invoked again at the current token stream position
+// while the contexts already built stay valid.
+// The precedence stack needs no reset: the generated left recursive rules
+// unroll it in their exit handler while the bail out exception unwinds
+// (antlr 4.10 runtime, third_party/antlr4). Returns false if that no longer
+// holds, the caller then falls back to a full re-parse.
+static bool resetParserState(antlr4::Parser* parser) {
+  if (parser->getPrecedence() != 0) return false;
+  parser->getErrorHandler()->reset(parser);
+  parser->setContext(nullptr);
+  parser->getInterpreter<antlr4::atn::ParserATNSimulator>()->reset();
+  return true;
+}
+
 ParseFile::ParseFile(PathId fileId, SymbolTable* symbolTable,
                      ErrorContainer* errors)
     : m_fileId(fileId),
@@ -150,55 +239,67 @@ void ParseFile::addError(Error& error) {
   getCompileSourceFile()->getErrorContainer()->addError(error);
 }
 
+// Maps a preprocessed line to its source file and line, "index" being the
+// last include info to consider.
+static void lineInfo(const std::vector<IncludeFileInfo>& infos,
+                     unsigned int lineItr, unsigned int index,
+                     PathId* fileId, unsigned int* line) {
+  while (1) {
+    if ((lineItr >= infos[index].m_originalStartLine) &&
+        (infos[index].m_action == IncludeFileInfo::Action::POP)) {
+      *fileId = infos[index].m_sectionFileId;
+      *line = infos[index].m_sectionStartLine +
+              (lineItr - infos[index].m_originalStartLine);
+      return;
+    }
+    if ((lineItr >= infos[index].m_originalStartLine) &&
+        (infos[index].m_action == IncludeFileInfo::Action::PUSH) &&
+        (infos[index].m_indexClosing > -1) &&
+        (lineItr < infos[infos[index].m_indexClosing].m_originalStartLine)) {
+      *fileId = infos[index].m_sectionFileId;
+      *line = infos[index].m_sectionStartLine +
+              (lineItr - infos[index].m_originalStartLine);
+      return;
+    }
+    if (index == 0) return;
+    index--;
+  }
+}
+
 void ParseFile::buildLineInfoCache_() {
   PreprocessFile* pp = getCompileSourceFile()->getPreprocessor();
   if (!pp) return;
   auto const& infos = pp->getIncludeFileInfo();
   if (!infos.empty()) {
-    fileInfoCache.resize(pp->getSumLineCount() + 10);
-    lineInfoCache.resize(pp->getSumLineCount() + 10);
+    // Infos are recorded in preprocessed output order, the ones starting
+    // after a line can't apply to it: sweep the lines and the infos together
+    // instead of scanning all the infos for each line.
+    bool sorted = true;
+    for (unsigned int i = 1; i < infos.size(); i++) {
+      if (infos[i].m_originalStartLine < infos[i - 1].m_originalStartLine) {
+        sorted = false;
+        break;
+      }
+    }
+    const unsigned int nbLines = pp->getSumLineCount() + 10;
+    fileInfoCache.resize(nbLines);
+    lineInfoCache.resize(nbLines);
     lineInfoCache[0] = 1;
     fileInfoCache[0] = m_fileId;
-    for (unsigned int lineItr = 1; lineItr < pp->getSumLineCount() + 10;
-         lineItr++) {
+    unsigned int last = 0;
+    for (unsigned int lineItr = 1; lineItr < nbLines; lineItr++) {
       fileInfoCache[lineItr] = m_fileId;
       lineInfoCache[lineItr] = lineItr;
-      bool inRange = false;
-      unsigned int indexOpeningRange = 0;
       unsigned int index = infos.size() - 1;
-      while (1) {
-        if ((lineItr >= infos[index].m_originalStartLine) &&
-            (infos[index].m_action == IncludeFileInfo::Action::POP)) {
-          fileInfoCache[lineItr] = infos[index].m_sectionFileId;
-          unsigned int l = infos[index].m_sectionStartLine +
-                           (lineItr - infos[index].m_originalStartLine);
-          lineInfoCache[lineItr] = l;
-          break;
+      if (sorted) {
+        while ((last + 1 < infos.size()) &&
+               (infos[last + 1].m_originalStartLine <= lineItr)) {
+          last++;
         }
-        if (infos[index].m_action == IncludeFileInfo::Action::POP) {
-          if (!inRange) {
-            inRange = true;
-            indexOpeningRange = infos[index].m_indexOpening;
-          }
-        } else {
-          if (inRange) {
-            if (index == indexOpeningRange) inRange = false;
-          }
-        }
-        if ((lineItr >= infos[index].m_originalStartLine) &&
-            (infos[index].m_action == IncludeFileInfo::Action::PUSH) &&
-            (infos[index].m_indexClosing > -1) &&
-            (lineItr <
-             infos[infos[index].m_indexClosing].m_originalStartLine)) {
-          fileInfoCache[lineItr] = infos[index].m_sectionFileId;
-          unsigned int l = infos[index].m_sectionStartLine +
-                           (lineItr - infos[index].m_originalStartLine);
-          lineInfoCache[lineItr] = l;
-          break;
-        }
-        if (index == 0) break;
-        index--;
+        index = last;
       }
+      lineInfo(infos, lineItr, index, &fileInfoCache[lineItr],
+               &lineInfoCache[lineItr]);
     }
   }
 }
@@ -271,7 +372,17 @@ bool ParseFile::parseOneFile_(PathId fileId, unsigned int lineOffset) {
   PreprocessFile* pp = getCompileSourceFile()->getPreprocessor();
   Timer tmr;
   m_antlrParserHandler = new AntlrParserHandler();
-  if (m_sourceText.empty()) {
+  // When the file was preprocessed in this process, its output is still in
+  // memory: hand it over to the lexer instead of reading it back from disk.
+  std::string_view ppResult;
+  if (m_sourceText.empty() && (m_parent == nullptr) && (pp != nullptr) &&
+      !pp->usingCachedVersion() && !clp->parseOnly() && !clp->lowMem()) {
+    ppResult = pp->getPreProcessedResult();
+  }
+  if (!ppResult.empty()) {
+    m_antlrParserHandler->m_inputStream =
+        new antlr4::ANTLRInputStream(ppResult);
+  } else if (m_sourceText.empty()) {
     std::istream& stream = fileSystem->openForRead(fileId);
     if (!stream.good()) {
       Location ppfile(fileId);
@@ -359,8 +470,9 @@ bool ParseFile::parseOneFile_(PathId fileId, unsigned int lineOffset) {
       ->getInterpreter<antlr4::atn::ParserATNSimulator>()
       ->setPredictionMode(antlr4::atn::PredictionMode::SLL);
   m_antlrParserHandler->m_parser->removeErrorListeners();
-  m_antlrParserHandler->m_parser->setErrorHandler(
-      std::make_shared<antlr4::BailErrorStrategy>());
+  std::shared_ptr<SllBailErrorStrategy> sllStrategy =
+      std::make_shared<SllBailErrorStrategy>();
+  m_antlrParserHandler->m_parser->setErrorHandler(sllStrategy);
 
   try {
     m_antlrParserHandler->m_tree =
@@ -374,6 +486,24 @@ bool ParseFile::parseOneFile_(PathId fileId, unsigned int lineOffset) {
       profileParser();
     }
   } catch (antlr4::ParseCancellationException& pex) {
+    m_decisionProfile.emplace_back("sll_bail", sllStrategy->m_decision,
+                                   sllStrategy->m_rule,
+                                   sllStrategy->m_line + m_offsetLine, 1);
+    // Only re-parse the enclosing top level description in LL mode, and
+    // resume SLL parsing after it.
+    if (reparseDescriptionsLL_(sllStrategy.get())) {
+      if (getCompileSourceFile()->getCommandLineParser()->profile()) {
+        StrAppend(&m_profileInfo, "SLL/LL Parsing: ",
+                  StringUtils::to_string(tmr.elapsed_rounded()), "s ",
+                  fileSystem->toPath(fileId), "\n");
+        tmr.reset();
+        profileParser();
+      }
+      return true;
+    }
+
+    // Genuine syntax error (or no enclosing description), re-parse the whole
+    // file in LL mode with error recovery and reporting.
     m_antlrParserHandler->m_tokens->reset();
     m_antlrParserHandler->m_parser->reset();
     m_antlrParserHandler->m_parser->removeErrorListeners();
@@ -398,43 +528,113 @@ bool ParseFile::parseOneFile_(PathId fileId, unsigned int lineOffset) {
       profileParser();
     }
   }
-  /* Failed attempt to minimize memory usage:
-     m_antlrParserHandler->m_parser->getInterpreter<antlr4::atn::ParserATNSimulator>()->clearDFA();
-     SV3_1aParser::_sharedContextCache.clear();
-  */
+  // The prediction DFA is shared by all the files and is kept, the per-file
+  // tokens and parse tree are released by releaseParserHandler_() once the
+  // AST is built (-boundedmem).
+  return true;
+}
+
+void ParseFile::releaseParserHandler_() {
+  if (m_keepParserHandler) return;  // Python listener walks the tree later
+  if (!getCompileSourceFile()->getCommandLineParser()->boundedMem()) return;
+  // The listener refers to the token stream
+  delete m_listener;
+  m_listener = nullptr;
+  delete m_antlrParserHandler;
+  m_antlrParserHandler = nullptr;
+}
+
+bool ParseFile::reparseDescriptionsLL_(SllBailErrorStrategy* strategy) {
+  SV3_1aParser::DescriptionContext* failed = strategy->m_description;
+  SV3_1aParser::Source_textContext* sourceText = strategy->m_sourceText;
+  SV3_1aParser::Top_level_ruleContext* topLevelRule = strategy->m_topLevelRule;
+  if ((failed == nullptr) || (sourceText == nullptr) ||
+      (topLevelRule == nullptr) || sourceText->children.empty() ||
+      (sourceText->children.back() != failed)) {
+    return false;
+  }
+  SV3_1aParser* parser = m_antlrParserHandler->m_parser;
+  antlr4::CommonTokenStream* tokens = m_antlrParserHandler->m_tokens;
+  antlr4::atn::ParserATNSimulator* interpreter =
+      parser->getInterpreter<antlr4::atn::ParserATNSimulator>();
+
+  // Drop the partially built description, the descriptions parsed before it
+  // are kept as is.
+  const size_t restartIndex = failed->getStart()->getTokenIndex();
+  sourceText->children.pop_back();
+
+  std::vector<SV3_1aParser::DescriptionContext*> descriptions;
+  bool llMode = true;
+  tokens->seek(restartIndex);
+  if (!resetParserState(parser)) return false;
+  while (tokens->LA(1) != antlr4::Token::EOF) {
+    const size_t startIndex = tokens->index();
+    interpreter->setPredictionMode(llMode ? antlr4::atn::PredictionMode::LL
+                                          : antlr4::atn::PredictionMode::SLL);
+    try {
+      descriptions.push_back(parser->description());
+      if (tokens->index() == startIndex) return false;
+      if (llMode) {
+        m_decisionProfile.emplace_back(
+            "ll_reparse", -1, "description",
+            tokens->get(startIndex)->getLine() + m_offsetLine, 1);
+      }
+      llMode = false;
+    } catch (antlr4::ParseCancellationException& pex) {
+      // A description that fails in LL mode is a genuine syntax error.
+      if (llMode) return false;
+      m_decisionProfile.emplace_back("sll_bail", strategy->m_decision,
+                                     strategy->m_rule,
+                                     strategy->m_line + m_offsetLine, 1);
+      llMode = true;
+      tokens->seek(startIndex);
+      if (!resetParserState(parser)) return false;
+    }
+  }
+
+  // Graft the re-parsed descriptions in place of the failed one
+  for (SV3_1aParser::DescriptionContext* description : descriptions) {
+    description->parent = sourceText;
+    sourceText->children.push_back(description);
+  }
+  sourceText->exception = nullptr;
+  topLevelRule->exception = nullptr;
+  if (antlr4::Token* last = tokens->LT(-1)) sourceText->stop = last;
+  topLevelRule->stop = tokens->LT(1);
+  interpreter->setPredictionMode(antlr4::atn::PredictionMode::SLL);
+  m_antlrParserHandler->m_tree = topLevelRule;
   return true;
 }
 
 void ParseFile::profileParser() {
-  // Core dumps
-  /*
-  for (auto iterator =
-  m_antlrParserHandler->m_parser->getParseInfo().getDecisionInfo().begin();
-       iterator !=
-  m_antlrParserHandler->m_parser->getParseInfo().getDecisionInfo().end();
-  iterator++) { antlr4::atn::DecisionInfo& decisionInfo = *iterator;
-    antlr4::atn::DecisionState* ds =
-        m_antlrParserHandler->m_parser->getATN().getDecisionState(decisionInfo.decision);
-    std::string rule =
-  m_antlrParserHandler->m_parser->getRuleNames()[ds->ruleIndex]; if
-  (decisionInfo.timeInPrediction > 0) { std::cout << std::left << std::setw(35)
-  << std::setfill(' ') << rule; std::cout << std::left << std::setw(15) <<
-  std::setfill(' ')
-                << decisionInfo.timeInPrediction;
-      std::cout << std::left << std::setw(15) << std::setfill(' ')
-                << decisionInfo.invocations;
-      std::cout << std::left << std::setw(15) << std::setfill(' ')
-                << decisionInfo.SLL_TotalLook;
-      std::cout << std::left << std::setw(15) << std::setfill(' ')
-                << decisionInfo.SLL_MaxLook;
-      std::cout << std::left << std::setw(15) << std::setfill(' ')
-                << decisionInfo.ambiguities.size();
-      std::cout << std::left << std::setw(15) << std::setfill(' ')
-                << decisionInfo.errors.size();
-      std::cout << std::endl;
+  SV3_1aParser* parser = m_antlrParserHandler->m_parser;
+  // Keep a copy, the decision info is returned by value: the former loop
+  // compared begin() and end() iterators of two different temporaries,
+  // which is what made it dump core.
+  const std::vector<antlr4::atn::DecisionInfo> decisions =
+      parser->getParseInfo().getDecisionInfo();
+  for (const antlr4::atn::DecisionInfo& decisionInfo : decisions) {
+    if ((decisionInfo.LL_Fallback == 0) && decisionInfo.ambiguities.empty() &&
+        decisionInfo.contextSensitivities.empty()) {
+      continue;
+    }
+    const antlr4::atn::DecisionState* ds =
+        parser->getATN().getDecisionState(decisionInfo.decision);
+    const std::string& rule = parser->getRuleNames()[ds->ruleIndex];
+    if (decisionInfo.LL_Fallback > 0) {
+      m_decisionProfile.emplace_back("ll_fallback", decisionInfo.decision, rule,
+                                     0, decisionInfo.LL_Fallback);
+    }
+    if (!decisionInfo.ambiguities.empty()) {
+      m_decisionProfile.emplace_back("ambiguity", decisionInfo.decision, rule,
+                                     0, decisionInfo.ambiguities.size());
+    }
+    if (!decisionInfo.contextSensitivities.empty()) {
+      m_decisionProfile.emplace_back("context_sensitivity",
+                                     decisionInfo.decision, rule, 0,
+                                     decisionInfo.contextSensitivities.size());
     }
   }
-  */
 }
 
 std::string ParseFile::getProfileInfo() const {
@@ -446,6 +646,26 @@ std::string ParseFile::getProfileInfo() const {
   return profile;
 }
 
+// Holds a -boundedmem parse slot until release() or the end of the scope,
+// a file that throws while being parsed does not keep its slot.
+class ParseSlotGuard final {
+ public:
+  explicit ParseSlotGuard(Compiler* compiler) : m_compiler(compiler) {
+    if (m_compiler != nullptr) m_compiler->acquireParseSlot();
+  }
+  ParseSlotGuard(const ParseSlotGuard&) = delete;
+  ParseSlotGuard& operator=(const ParseSlotGuard&) = delete;
+  ~ParseSlotGuard() { release(); }
+
+  void release() {
+    if (m_compiler != nullptr) m_compiler->releaseParseSlot();
+    m_compiler = nullptr;
+  }
+
+ private:
+  Compiler* m_compiler;
+};
+
 bool ParseFile::parse() {
   FileSystem* const fileSystem = FileSystem::getInstance();
   CommandLineParser* clp = getCompileSourceFile()->getCommandLineParser();
@@ -455,7 +675,7 @@ bool ParseFile::parse() {
   if (m_children.empty()) {
     ParseCache cache(this);
 
-    if (cache.restore()) {
+    if (cache.restore() || cache.restoreFromFileUnit()) {
       m_usingCachedVersion = true;
       if (debug_AstModel && !precompiled)
         std::cout << m_fileContent->printObjects();
@@ -488,6 +708,17 @@ bool ParseFile::parse() {
     }
   }
 
+  // A standalone file builds its AST right after parsing. In bounded memory
+  // mode so does a chunk: the parent file only walks its chunks once they are
+  // all parsed, a chunk waiting for it would keep its parse slot until then.
+  // The file holds a parse slot from its tokenization until its ANTLR data is
+  // released.
+  const bool walkHere =
+      m_children.empty() &&
+      ((m_parent == nullptr) || (clp->boundedMem() && !m_keepParserHandler));
+  ParseSlotGuard parseSlot(walkHere ? getCompileSourceFile()->getCompiler()
+                                    : nullptr);
+
   // This is not a parent Parser object
   if (m_children.empty()) {
     // std::cout << std::endl << "Parsing " << getSymbol(m_ppFileId) << "
@@ -504,10 +735,13 @@ bool ParseFile::parse() {
   }
 
   // This is either a parent Parser object of this Parser object has no parent
-  if (!m_children.empty() || (m_parent == nullptr)) {
-    if ((m_parent == nullptr) && (m_children.empty())) {
+  if (!m_children.empty() || walkHere) {
+    if (walkHere) {
       Timer tmr;
 
+      if (m_parent != nullptr) {
+        m_fileContent->setParent(m_parent->m_fileContent);
+      }
       m_listener = new SV3_1aTreeShapeListener(
           this, m_antlrParserHandler->m_tokens, m_offsetLine);
       antlr4::tree::ParseTreeWalker::DEFAULT.walk(m_listener,
@@ -516,6 +750,9 @@ bool ParseFile::parse() {
       if (debug_AstModel && !precompiled)
         std::cout << m_fileContent->printObjects();
 
+      releaseParserHandler_();
+      parseSlot.release();
+
       if (clp->profile()) {
         // m_profileInfo += "AST Walking: " + std::to_string
         // (tmr.elapsed_rounded ()) + "\n";
@@ -541,7 +778,8 @@ bool ParseFile::parse() {
     if (!m_children.empty()) {
       for (ParseFile* child : m_children) {
         if (child->m_antlrParserHandler) {
-          // Only visit the chunks that got re-parsed
+          // Only visit the chunks that got re-parsed, under -boundedmem they
+          // built their AST and released their ANTLR data already
           // TODO: Incrementally regenerate the FileContent
           child->m_fileContent->setParent(m_fileContent);
           child->m_listener = new SV3_1aTreeShapeListener(
@@ -562,6 +800,8 @@ bool ParseFile::parse() {
           if (debug_AstModel && !precompiled)
             std::cout << child->m_fileContent->printObjects();
 
+          child->releaseParserHandler_();
+
           ParseCache cache(child);
           if (clp->link()) return true;
           if (!cache.save()) {
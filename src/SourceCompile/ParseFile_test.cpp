@@ -14,17 +14,85 @@
  limitations under the License.
 */
 
+#include <Surelog/API/Surelog.h>
+#include <Surelog/CommandLine/CommandLineParser.h>
+#include <Surelog/Common/PlatformFileSystem.h>
+#include <Surelog/Design/DesignElement.h>
 #include <Surelog/Design/FileContent.h>
+#include <Surelog/ErrorReporting/ErrorContainer.h>
+#include <Surelog/SourceCompile/CompileSourceFile.h>
+#include <Surelog/SourceCompile/Compiler.h>
 #include <Surelog/SourceCompile/ParseFile.h>
 #include <Surelog/SourceCompile/ParserHarness.h>
 #include <Surelog/SourceCompile/SymbolTable.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace SURELOG {
+namespace fs = std::filesystem;
 using ::testing::ElementsAre;
 
 namespace {
+class TestFileSystem : public PlatformFileSystem {
+ public:
+  explicit TestFileSystem(const fs::path& wd) : PlatformFileSystem(wd) {
+    FileSystem::setInstance(this);
+  }
+};
+
+// Parses the file split in chunks on 4 threads and returns the number of
+// files parsed (chunks included), followed by the sorted names of the design
+// elements found in them.
+std::vector<std::string> ParseSplitFile(const fs::path& file,
+                                        bool boundedMem) {
+  const fs::path kProgramFile = FileSystem::getProgramPath();
+  std::unique_ptr<SymbolTable> symbolTable(new SymbolTable);
+  std::unique_ptr<ErrorContainer> errors(new ErrorContainer(symbolTable.get()));
+  std::unique_ptr<CommandLineParser> clp(
+      new CommandLineParser(errors.get(), symbolTable.get(), false, false));
+  std::vector<std::string> args{
+      kProgramFile.string(), "-nostdout", "-nobuiltin", "-nocache",
+      "-parseonly",          "-split",    "10",         "-mt",
+      "4"};
+  if (boundedMem) {
+    args.emplace_back("-boundedmem");
+    args.emplace_back("1");
+  }
+  args.emplace_back(file.string());
+  args.emplace_back("-o");
+  args.emplace_back((file.parent_path() / "out").string());
+  std::vector<const char*> cargs;
+  std::transform(args.begin(), args.end(), std::back_inserter(cargs),
+                 [](const std::string& arg) { return arg.data(); });
+  clp->parseCommandLine(cargs.size(), cargs.data());
+
+  std::vector<std::string> results;
+  scompiler* compiler = start_compiler(clp.get());
+  if (compiler == nullptr) return results;
+  const std::vector<CompileSourceFile*>& csfs =
+      ((Compiler*)compiler)->getCompileSourceFiles();
+  std::vector<std::string> names;
+  for (CompileSourceFile* csf : csfs) {
+    FileContent* fC = csf->getParser()->getFileContent();
+    for (const DesignElement* elem : fC->getDesignElements()) {
+      names.emplace_back(fC->getSymbolTable()->getSymbol(elem->m_name));
+    }
+  }
+  std::sort(names.begin(), names.end());
+  results.emplace_back(std::to_string(csfs.size()));
+  results.insert(results.end(), names.begin(), names.end());
+  shutdown_compiler(compiler);
+  return results;
+}
+
 TEST(ParserTest, BasicParse) {
   ParserHarness harness;
   {
@@ -57,5 +125,102 @@ TEST(ParserTest, BasicParse) {
     EXPECT_EQ(fC->Type(Unary_Not), VObjectType::slUnary_Not);
   }
 }
+
+TEST(ParserTest, ReparsedDescriptionKeepsEarlierOnes) {
+  // When the SLL pass bails out in a later description, only that
+  // description is re-parsed in LL mode and grafted after the descriptions
+  // already built: they have to survive the re-parse, in order.
+  ParserHarness harness;
+  auto fC = harness.parse(
+      "module first(); assign a = b; endmodule\n"
+      "package p;\n"
+      "  typedef class c;\n"
+      "  class pool #(type KEY = int, T = c) extends c;\n"
+      "    protected T m_pool[KEY];\n"
+      "    static function pool #(KEY, T) get_global_pool();\n"
+      "      static pool #(KEY, T) m_global_pool = new;\n"
+      "      return m_global_pool;\n"
+      "    endfunction\n"
+      "    virtual function T get(KEY key);\n"
+      "      if (!m_pool.exists(key)) begin T default_value; return "
+      "default_value; end\n"
+      "      return m_pool[key];\n"
+      "    endfunction\n"
+      "  endclass : pool\n"
+      "endpackage : p\n"
+      "module last(); assign c = !d; endmodule\n");
+  ASSERT_NE(fC, nullptr);
+  NodeId root = fC->getRootNode();
+  NodeId sourceText = fC->sl_collect(root, VObjectType::slSource_text);
+  ASSERT_TRUE(sourceText);
+  std::vector<NodeId> descriptions =
+      fC->sl_collect_all(root, VObjectType::slDescription);
+  ASSERT_EQ(descriptions.size(), 3U);
+  for (NodeId description : descriptions) {
+    EXPECT_EQ(fC->Parent(description), sourceText);
+  }
+  EXPECT_EQ(fC->Type(fC->Child(descriptions[0])),
+            VObjectType::slModule_declaration);
+  EXPECT_EQ(fC->Type(fC->Child(descriptions[1])),
+            VObjectType::slPackage_declaration);
+  EXPECT_EQ(fC->Type(fC->Child(descriptions[2])),
+            VObjectType::slModule_declaration);
+  EXPECT_EQ(fC->SymName(fC->sl_collect(descriptions[0],
+                                       VObjectType::slStringConst)),
+            "first");
+  EXPECT_EQ(fC->SymName(fC->sl_collect(descriptions[2],
+                                       VObjectType::slStringConst)),
+            "last");
+  EXPECT_TRUE(
+      fC->sl_collect(descriptions[1], VObjectType::slClass_declaration));
+  EXPECT_TRUE(
+      fC->sl_collect(descriptions[2], VObjectType::slContinuous_assign));
+
+  // The SLL pass bailed out in the package, which alone was re-parsed in LL
+  // mode: a full-file LL re-parse records no ll_reparse event.
+  const ParseFile* parseFile = harness.parseFile();
+  ASSERT_NE(parseFile, nullptr);
+  std::vector<std::pair<std::string, unsigned int>> events;
+  for (const ParseFile::DecisionProfileInfo& info :
+       parseFile->getDecisionProfile()) {
+    events.emplace_back(info.m_event, info.m_line);
+  }
+  ASSERT_EQ(events.size(), 2U);
+  EXPECT_EQ(events[0].first, "sll_bail");
+  EXPECT_GE(events[0].second, 2U);
+  EXPECT_LE(events[0].second, 15U);
+  EXPECT_EQ(events[1], std::make_pair(std::string("ll_reparse"), 2U));
+}
+
+TEST(ParserTest, BoundedMemParsesChunksOfSplitFile) {
+  const fs::path kBaseDir = fs::path(testing::TempDir()) / "boundedmem";
+  std::error_code ec;
+  fs::remove_all(kBaseDir, ec);
+  fs::create_directories(kBaseDir, ec);
+  std::unique_ptr<FileSystem> fileSystem(new TestFileSystem(kBaseDir));
+
+  const fs::path file = kBaseDir / "top.sv";
+  std::string content;
+  for (int i = 0; i < 8; ++i) {
+    const std::string index = std::to_string(i);
+    content += "module m" + index + "(input a, output b);\n";
+    content += "  wire c = a;\n";
+    content += "  assign b = !c;\n";
+    content += "endmodule\n";
+  }
+  SymbolTable symbols;
+  ASSERT_TRUE(fileSystem->writeContent(
+      fileSystem->toPathId(file.string(), &symbols), content));
+
+  // A single parse slot is shared by the chunks: each one gives it up once
+  // it built its AST instead of waiting for the parent file.
+  const std::vector<std::string> unbounded = ParseSplitFile(file, false);
+  const std::vector<std::string> bounded = ParseSplitFile(file, true);
+  ASSERT_EQ(unbounded.size(), 9U);
+  EXPECT_GT(std::stoi(unbounded.front()), 1);
+  EXPECT_EQ(bounded, unbounded);
+
+  fs::remove_all(kBaseDir, ec);
+}
 }  // namespace
 }  // namespace SURELOG
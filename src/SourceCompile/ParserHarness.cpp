@@ -88,6 +88,10 @@ FileContent* ParserHarness::parse(const std::string& content,
   return file_content_result;
 }
 
+const ParseFile* ParserHarness::parseFile() const {
+  return (m_h == nullptr) ? nullptr : m_h->pf.get();
+}
+
 ParserHarness::~ParserHarness() { delete m_h; }
 
 }  // namespace SURELOG
@@ -31,6 +31,7 @@
 #include <Surelog/SourceCompile/CompilationUnit.h>
 #include <Surelog/SourceCompile/CompileSourceFile.h>
 #include <Surelog/SourceCompile/Compiler.h>
+#include <Surelog/SourceCompile/MacroExpander.h>
 #include <Surelog/SourceCompile/MacroInfo.h>
 #include <Surelog/SourceCompile/PreprocessFile.h>
 #include <Surelog/SourceCompile/SV3_1aPpTreeShapeListener.h>
@@ -41,8 +42,9 @@
 #include <parser/SV3_1aPpLexer.h>
 #include <parser/SV3_1aPpParser.h>
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
-#include <regex>
 #include <string_view>
 
 namespace SURELOG {
@@ -277,17 +279,19 @@ std::string PreprocessFile::getSymbol(SymbolId id) const {
   return getCompileSourceFile()->getSymbolTable()->getSymbol(id);
 }
 
-SymbolId PreprocessFile::getMacroSignature() {
-  FileSystem* const fileSystem = FileSystem::getInstance();
-  std::ostringstream strm;
-  strm << getSymbol(m_macroId);
+uint64_t PreprocessFile::getMacroSignature() const {
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](uint64_t value) {
+    hash ^= value;
+    hash *= 1099511628211ULL;
+  };
+  mix((RawSymbolId)m_macroId);
   if (m_macroInfo) {
-    strm << "|" << fileSystem->toPath(m_macroInfo->m_fileId) << "|"
-         << std::to_string(m_macroInfo->m_startLine);
+    mix((RawPathId)m_macroInfo->m_fileId);
+    mix(m_macroInfo->m_startLine);
   }
-  strm << "|" << m_macroBody;
-  SymbolId sigId = registerSymbol(strm.str());
-  return sigId;
+  mix(std::hash<std::string_view>{}(m_macroBody));
+  return hash;
 }
 
 PreprocessFile::~PreprocessFile() {
@@ -321,7 +325,7 @@ bool PreprocessFile::preprocess() {
   FileSystem* const fileSystem = FileSystem::getInstance();
   Timer tmr;
   bool precompiled = false;
-  SymbolId macroSignatureId;
+  uint64_t macroSignature = 0;
   if (m_macroBody.empty()) {
     precompiled = Precompiled::getSingleton()->isFilePrecompiled(
         m_fileId, getCompileSourceFile()->getSymbolTable());
@@ -343,14 +347,15 @@ bool PreprocessFile::preprocess() {
     }
   } else {
     macroName = getSymbol(m_macroId);
-    macroSignatureId = getMacroSignature();
+    macroSignature = getMacroSignature();
   }
   if (clp->parseOnly() || clp->lowMem() || clp->link()) return true;
 
   m_antlrParserHandler =
       m_macroBody.empty()
           ? getCompileSourceFile()->getAntlrPpHandlerForId(m_fileId)
-          : getCompileSourceFile()->getAntlrPpHandlerForId(macroSignatureId);
+          : getCompileSourceFile()->getAntlrPpHandlerForMacro(macroSignature,
+                                                              m_macroBody);
 
   if (m_antlrParserHandler == nullptr) {
     m_antlrParserHandler = new AntlrParserHandler();
@@ -521,8 +526,8 @@ bool PreprocessFile::preprocess() {
       getCompileSourceFile()->registerAntlrPpHandlerForId(m_fileId,
                                                           m_antlrParserHandler);
     } else {
-      getCompileSourceFile()->registerAntlrPpHandlerForId(macroSignatureId,
-                                                          m_antlrParserHandler);
+      getCompileSourceFile()->registerAntlrPpHandlerForMacro(
+          macroSignature, m_macroBody, m_antlrParserHandler);
     }
   }
   m_result.clear();
@@ -531,14 +536,36 @@ bool PreprocessFile::preprocess() {
   m_listener = new SV3_1aPpTreeShapeListener(
       this, m_antlrParserHandler->m_pptokens, m_instructions);
   // TODO: this leaks
+  ++m_antlrParserHandler->m_activeWalks;
   tree::ParseTreeWalker::DEFAULT.walk(m_listener,
                                       m_antlrParserHandler->m_pptree);
+  --m_antlrParserHandler->m_activeWalks;
+  // Macro body handlers belong to the bounded cache and may be evicted
+  if (!m_macroBody.empty()) m_antlrParserHandler = nullptr;
   if (m_debugAstModel && !precompiled)
     std::cout << m_fileContent->printObjects();
   m_lineCount = LinesCount(m_result);
   return true;
 }
 
+bool PreprocessFile::expandMacroBody_() {
+  CommandLineParser* clp = getCompileSourceFile()->getCommandLineParser();
+  if (clp->parseOnly() || clp->lowMem() || clp->link() ||
+      !clp->macroExpander()) {
+    return false;
+  }
+  MacroExpander expander(this);
+  if (!expander.tokenize(m_macroBody)) return false;
+  if (m_debugPP) {
+    std::cout << "PP EXPAND MACRO: " << m_macroBody << std::endl;
+  }
+  m_result.clear();
+  m_lineCount = 0;
+  expander.expand();
+  m_lineCount = LinesCount(m_result);
+  return true;
+}
+
 unsigned int PreprocessFile::getSumLineCount() {
   unsigned int total = m_lineCount;
   if (m_includer) total += m_includer->getSumLineCount();
@@ -690,7 +717,7 @@ void PreprocessFile::checkMacroArguments_(
     bool check = false;
     if ((s1.find("``") != std::string::npos) && (s1 != "``"))  // ``a``
     {
-      s1 = std::regex_replace(s1, std::regex("``"), "");
+      s1 = StringUtils::replaceAll(s1, "``", "");
       s2 = s1;
       check = true;
     } else if (s1 == "``") {
@@ -797,8 +824,7 @@ std::pair<bool, std::string> PreprocessFile::evaluateMacro_(
   FileSystem* const fileSystem = FileSystem::getInstance();
   std::string result;
   bool found = false;
-  const std::vector<std::string>& formal_args = macroInfo->m_arguments;
-  const std::vector<std::string>& orig_body_tokens = macroInfo->m_tokens;
+  const std::vector<MacroInfo::Formal>& formal_args = macroInfo->m_formals;
 
   if (instructions.m_check_macro_loop) {
     bool loop = loopChecker.addEdge(callingFile->m_macroId, getId(name));
@@ -818,21 +844,6 @@ std::pair<bool, std::string> PreprocessFile::evaluateMacro_(
       }
     }
   }
-  // Don't modify the actual tokens of the macro, make a copy...
-  std::vector<std::string> body_tokens;
-  for (const std::string& tok : orig_body_tokens) {
-    if (tok == "``_``") {
-      body_tokens.push_back("``");
-      body_tokens.push_back("_");
-      body_tokens.push_back("``");
-    } else {
-      body_tokens.push_back(tok);
-    }
-  }
-
-  StringUtils::replaceInTokenVector(body_tokens, "`\"", "\"");
-  StringUtils::replaceInTokenVector(body_tokens, "`\\`\"", "\\\"");
-
   // argument substitution
   for (std::string& actual_arg : actual_args) {
     if (actual_arg.find('`') != std::string::npos) {
@@ -844,7 +855,8 @@ std::pair<bool, std::string> PreprocessFile::evaluateMacro_(
   }
 
   if ((actual_args.size() > formal_args.size() && (!m_instructions.m_mute))) {
-    if (formal_args.empty() && (getFirstNonEmptyToken(body_tokens) == "(")) {
+    if (formal_args.empty() &&
+        (getFirstNonEmptyToken(macroInfo->getTokens()) == "(")) {
       Location loc(macroInfo->m_fileId, macroInfo->m_startLine,
                    macroInfo->m_startColumn + name.size() + 1, getId(name));
       Error err(ErrorDefinition::PP_MACRO_HAS_SPACE_BEFORE_ARGS, loc);
@@ -863,12 +875,11 @@ std::pair<bool, std::string> PreprocessFile::evaluateMacro_(
     }
   }
   bool incorrectArgNb = false;
-  static const std::regex ws_re("[ \t]+");
+  // Value of each formal argument, actual[i] is false when it is the default
+  // value or left empty
+  std::vector<std::string_view> values(formal_args.size());
+  std::vector<bool> actual(formal_args.size(), false);
   for (unsigned int i = 0; i < formal_args.size(); i++) {
-    std::vector<std::string> formal_arg_default;
-    StringUtils::tokenize(formal_args[i], "=", formal_arg_default);
-    const std::string formal =
-        std::regex_replace(formal_arg_default[0], ws_re, "");
     bool empty_actual = true;
     if (i < actual_args.size()) {
       for (char c : actual_args[i]) {
@@ -882,110 +893,82 @@ std::pair<bool, std::string> PreprocessFile::evaluateMacro_(
       if (actual_args[i] == SymbolTable::getEmptyMacroMarker()) {
         actual_args[i].clear();
       }
-
-      const std::string pattern = "`" + formal;
-      StringUtils::replaceInTokenVector(body_tokens, {"``", pattern, "``"},
-                                        "`" + actual_args[i]);
-      StringUtils::replaceInTokenVector(body_tokens, {"``", formal, "``"},
-                                        actual_args[i]);
-      StringUtils::replaceInTokenVector(body_tokens, "``" + formal + "``",
-                                        actual_args[i]);
-      StringUtils::replaceInTokenVector(body_tokens, {formal, "``"},
-                                        actual_args[i]);
-      StringUtils::replaceInTokenVector(body_tokens, {"``", formal},
-                                        actual_args[i]);
-      StringUtils::replaceInTokenVector(body_tokens, {formal, " ", "``"},
-                                        actual_args[i]);
-      StringUtils::replaceInTokenVector(body_tokens, formal + "``",
-                                        actual_args[i]);
-      StringUtils::replaceInTokenVector(body_tokens, formal, actual_args[i]);
-    } else if (formal_arg_default.size() == 2) {
-      const std::string default_val =
-          std::regex_replace(formal_arg_default[1], ws_re, "");
-      StringUtils::replaceInTokenVector(body_tokens, {"``", formal, "``"},
-                                        default_val);
-      StringUtils::replaceInTokenVector(body_tokens, "``" + formal + "``",
-                                        default_val);
-      StringUtils::replaceInTokenVector(body_tokens, {formal, "``"},
-                                        default_val);
-      StringUtils::replaceInTokenVector(body_tokens, {"``", formal},
-                                        default_val);
-      StringUtils::replaceInTokenVector(body_tokens, {formal, " ", "``"},
-                                        default_val);
-      StringUtils::replaceInTokenVector(body_tokens, formal + "``",
-                                        default_val);
-      StringUtils::replaceInTokenVector(body_tokens, formal, default_val);
-    } else {
-      StringUtils::replaceInTokenVector(body_tokens, {"``", formal, "``"}, "");
-      StringUtils::replaceInTokenVector(body_tokens, "``" + formal + "``", "");
-      StringUtils::replaceInTokenVector(body_tokens, {formal, "``"}, "");
-      StringUtils::replaceInTokenVector(body_tokens, {"``", formal}, "");
-      StringUtils::replaceInTokenVector(body_tokens, {formal, " ", "``"}, "");
-      StringUtils::replaceInTokenVector(body_tokens, formal + "``", "");
-      StringUtils::replaceInTokenVector(body_tokens, formal, "");
-
-      if ((int)i > (int)(((int)actual_args.size()) - 1)) {
-        if (!instructions.m_mute) {
-          Location loc(callingFile->getFileId(callingLine),
-                       callingFile->getLineNb(callingLine), 0, getId(name));
-          SymbolId id =
-              registerSymbol(std::to_string(i + 1) + " (" + formal + ")");
-          Location arg(id);
-          Location def(macroInfo->m_fileId, macroInfo->m_startLine,
-                       macroInfo->m_startColumn, id);
-          std::vector<Location> locs = {arg, def};
-          Error err(ErrorDefinition::PP_MACRO_NO_DEFAULT_VALUE, loc, &locs);
-          addError(err);
-        }
-        incorrectArgNb = true;
+      values[i] = actual_args[i];
+      actual[i] = true;
+    } else if (formal_args[i].m_hasDefault) {
+      values[i] = formal_args[i].m_default;
+    } else if ((int)i > (int)(((int)actual_args.size()) - 1)) {
+      if (!instructions.m_mute) {
+        Location loc(callingFile->getFileId(callingLine),
+                     callingFile->getLineNb(callingLine), 0, getId(name));
+        SymbolId id = registerSymbol(std::to_string(i + 1) + " (" +
+                                     formal_args[i].m_name + ")");
+        Location arg(id);
+        Location def(macroInfo->m_fileId, macroInfo->m_startLine,
+                     macroInfo->m_startColumn, id);
+        std::vector<Location> locs = {arg, def};
+        Error err(ErrorDefinition::PP_MACRO_NO_DEFAULT_VALUE, loc, &locs);
+        addError(err);
       }
+      incorrectArgNb = true;
     }
   }
   if (incorrectArgNb) {
     return std::make_pair(true, "`" + name);
   }
-  std::string body;
-  for (const auto& token : body_tokens) {
-    body += token;
-  }
+  std::string body = macroInfo->substitute(values, actual);
   if (!actual_args.empty() && formal_args.empty()) {
     body += "(";
     body += actual_args[0];
     body += ")";
   }
   // *** Body processing
-  std::string body_short;
-  // Replace \\n by \n
-  bool inString = false;
-  char previous = '\0';
-  for (char c : body) {
-    if (c == '"') {
-      inString = !inString;
-    }
-    if ((previous == '\\') && (c == '\n') && (!inString)) {
-      body_short.erase(body_short.end() - 1);
-      body_short.push_back(c);
-    } else {
-      body_short.push_back(c);
+  // Only line feeds are rewritten below, the body has some if the macro
+  // definition or an actual argument does.
+  bool multiLine = macroInfo->m_multiLine;
+  for (const std::string& actual_arg : actual_args) {
+    if (actual_arg.find('\n') != std::string::npos) {
+      multiLine = true;
+      break;
     }
-    previous = c;
   }
-  // Truncate trailing carriage returns (up to 2)
-
-  for (int i = 0; i < 2; i++) {
-    if (!body_short.empty()) {
-      if (body_short.at(body_short.size() - 1) == '\n') {
-        body_short.erase(body_short.size() - 1);
+  std::string body_short;
+  if (!multiLine || (body.find('\\') == std::string::npos)) {
+    body_short = std::move(body);
+  } else {
+    // Replace \\n by \n
+    body_short.reserve(body.size());
+    bool inString = false;
+    char previous = '\0';
+    for (char c : body) {
+      if (c == '"') {
+        inString = !inString;
+      }
+      if ((previous == '\\') && (c == '\n') && (!inString)) {
+        body_short.erase(body_short.end() - 1);
+        body_short.push_back(c);
       } else {
-        break;
+        body_short.push_back(c);
       }
+      previous = c;
     }
   }
+  if (multiLine) {
+    // Truncate trailing carriage returns (up to 2)
+    for (int i = 0; i < 2; i++) {
+      if (!body_short.empty()) {
+        if (body_short.at(body_short.size() - 1) == '\n') {
+          body_short.erase(body_short.size() - 1);
+        } else {
+          break;
+        }
+      }
+    }
 
-  // If it is a Multiline macro, insert a \n at the end
-
-  if (body_short.find('\n') != std::string::npos) {
-    body_short.push_back('\n');
+    // If it is a Multiline macro, insert a \n at the end
+    if (body_short.find('\n') != std::string::npos) {
+      body_short.push_back('\n');
+    }
   }
 
   if (body_short.find('`') != std::string::npos) {
@@ -1010,19 +993,23 @@ std::pair<bool, std::string> PreprocessFile::evaluateMacro_(
         callingFile ? callingFile : m_includer, callingLine, body_short,
         macroInfo, embeddedMacroCallLine - 1, embeddedMacroCallFile);
     getCompileSourceFile()->registerPP(pp);
-    if (!pp->preprocess()) {
+    if (!pp->expandMacroBody_() && !pp->preprocess()) {
       result = MacroNotDefined;
     } else {
       std::string pp_result = pp->getPreProcessedFileContent();
 
       if (callingLine && callingFile && !callingFile->isMacroBody()) {
-        pp_result = std::regex_replace(
-            pp_result, std::regex(PP__File__Marking),
-            StrCat("\"",
-                   fileSystem->toPath(callingFile->getFileId(callingLine)),
-                   "\""));
-        pp_result = std::regex_replace(pp_result, std::regex(PP__Line__Marking),
-                                       std::to_string(callingLine));
+        if (pp_result.find(PP__File__Marking) != std::string::npos) {
+          pp_result = StringUtils::replaceAll(
+              pp_result, PP__File__Marking,
+              StrCat("\"",
+                     fileSystem->toPath(callingFile->getFileId(callingLine)),
+                     "\""));
+        }
+        if (pp_result.find(PP__Line__Marking) != std::string::npos) {
+          pp_result = StringUtils::replaceAll(pp_result, PP__Line__Marking,
+                                              std::to_string(callingLine));
+        }
       }
       result = pp_result;
       found = true;
@@ -1151,7 +1138,9 @@ std::string PreprocessFile::getMacro(
             instructions, embeddedMacroCallLine, embeddedMacroCallFile);
         found = evalResult.first;
         result = evalResult.second;
-        result = std::regex_replace(result, std::regex("``"), "");
+        if (result.find("``") != std::string::npos) {
+          result = StringUtils::replaceAll(result, "``", "");
+        }
       }
     } else {
       if (info) {
@@ -14,18 +14,75 @@
  limitations under the License.
 */
 
+#include <Surelog/API/Surelog.h>
+#include <Surelog/CommandLine/CommandLineParser.h>
+#include <Surelog/Common/PlatformFileSystem.h>
+#include <Surelog/Design/Design.h>
+#include <Surelog/SourceCompile/CompilationUnit.h>
+#include <Surelog/SourceCompile/CompileSourceFile.h>
+#include <Surelog/SourceCompile/Compiler.h>
 #include <Surelog/SourceCompile/PreprocessHarness.h>
+#include <Surelog/SourceCompile/SymbolTable.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
 
 namespace SURELOG {
+namespace fs = std::filesystem;
 using ::testing::ElementsAre;
 
 namespace {
+class TestFileSystem : public PlatformFileSystem {
+ public:
+  explicit TestFileSystem(const fs::path &wd) : PlatformFileSystem(wd) {
+    FileSystem::setInstance(this);
+  }
+};
+
+// Preprocesses the files as one compilation unit on 4 threads and returns
+// the preprocessed text of each file, followed by the number of
+// preprocessor file contents the design kept.
+std::vector<std::string> PreprocessUnit(const std::vector<fs::path> &files,
+                                        bool speculative) {
+  const fs::path kProgramFile = FileSystem::getProgramPath();
+  std::unique_ptr<SymbolTable> symbolTable(new SymbolTable);
+  std::unique_ptr<ErrorContainer> errors(new ErrorContainer(symbolTable.get()));
+  std::unique_ptr<CommandLineParser> clp(
+      new CommandLineParser(errors.get(), symbolTable.get(), false, false));
+  std::vector<std::string> args{kProgramFile.string(), "-nostdout",
+                                "-nobuiltin", "-nocache", "-noparse",
+                                "-writepp", "-mt", "4"};
+  if (speculative) args.emplace_back("-specpp");
+  for (const fs::path &file : files) args.emplace_back(file.string());
+  args.emplace_back("-o");
+  args.emplace_back((files.front().parent_path() / "out").string());
+  std::vector<const char *> cargs;
+  std::transform(args.begin(), args.end(), std::back_inserter(cargs),
+                 [](const std::string &arg) { return arg.data(); });
+  clp->parseCommandLine(cargs.size(), cargs.data());
+
+  std::vector<std::string> results;
+  scompiler *compiler = start_compiler(clp.get());
+  if (compiler == nullptr) return results;
+  FileSystem *const fileSystem = FileSystem::getInstance();
+  for (CompileSourceFile *csf :
+       ((Compiler *)compiler)->getCompileSourceFiles()) {
+    std::string content;
+    EXPECT_TRUE(fileSystem->readContent(csf->getPpOutputFileId(), content));
+    results.emplace_back(content);
+  }
+  results.emplace_back(
+      std::to_string(get_design(compiler)->getAllPPFileContents().size()));
+  shutdown_compiler(compiler);
+  return results;
+}
 
 bool ContainsError(const ErrorContainer &errors,
                    ErrorDefinition::ErrorType etype) {
@@ -34,6 +91,41 @@ bool ContainsError(const ErrorContainer &errors,
       [etype](const Error &e) { return e.getType() == etype; });
 }
 
+// Preprocesses content with and without the macro expander and expects the
+// same text, errors and include file infos. Returns the include file infos.
+std::vector<IncludeFileInfo> ExpectSameAsGrammar(std::string_view content) {
+  PreprocessHarness expander;
+  expander.setMacroExpander(true);
+  const std::string expanded = expander.preprocess(content);
+  PreprocessHarness grammar;
+  const std::string parsed = grammar.preprocess(content);
+  EXPECT_EQ(expanded, parsed);
+  EXPECT_EQ(expander.collected_errors().getErrors().size(),
+            grammar.collected_errors().getErrors().size());
+
+  const std::vector<IncludeFileInfo> &infos =
+      expander.collected_include_file_infos();
+  const std::vector<IncludeFileInfo> &expected =
+      grammar.collected_include_file_infos();
+  EXPECT_EQ(infos.size(), expected.size());
+  for (size_t i = 0; i < std::min(infos.size(), expected.size()); ++i) {
+    SCOPED_TRACE("include file info " + std::to_string(i));
+    EXPECT_EQ(infos[i].m_context, expected[i].m_context);
+    EXPECT_EQ(infos[i].m_sectionStartLine, expected[i].m_sectionStartLine);
+    EXPECT_TRUE(infos[i].m_sectionSymbolId == expected[i].m_sectionSymbolId);
+    EXPECT_TRUE(infos[i].m_sectionFileId == expected[i].m_sectionFileId);
+    EXPECT_EQ(infos[i].m_originalStartLine, expected[i].m_originalStartLine);
+    EXPECT_EQ(infos[i].m_originalStartColumn,
+              expected[i].m_originalStartColumn);
+    EXPECT_EQ(infos[i].m_originalEndLine, expected[i].m_originalEndLine);
+    EXPECT_EQ(infos[i].m_originalEndColumn, expected[i].m_originalEndColumn);
+    EXPECT_EQ(infos[i].m_action, expected[i].m_action);
+    EXPECT_EQ(infos[i].m_indexOpening, expected[i].m_indexOpening);
+    EXPECT_EQ(infos[i].m_indexClosing, expected[i].m_indexClosing);
+  }
+  return infos;
+}
+
 TEST(PreprocessTest, PreprocessWithoutPPTokens) {
   PreprocessHarness harness;
   const std::string res = harness.preprocess("module top(); endmodule");
@@ -131,6 +223,75 @@ endmodule)");
                              ErrorDefinition::PP_TOO_MANY_ARGS_MACRO));
 }
 
+TEST(PreprocessTest, PreprocessNestedMacroExpansionInMacroBody) {
+  PreprocessHarness harness;
+  const std::string res = harness.preprocess(R"(
+`define W 8
+`define DECL(name) logic [`W-1:0] name
+`define PAIR(n) `DECL(n``_a); `DECL(n``_b)
+module top();
+  `PAIR(sig);
+endmodule)");
+
+  EXPECT_EQ(res, R"(
+module top();
+  logic [8-1:0] sig_a; logic [8-1:0] sig_b;
+endmodule)");
+}
+
+TEST(PreprocessTest, DefaultArgumentExpansion) {
+  PreprocessHarness harness;
+  const std::string res = harness.preprocess(R"(
+`define ADD(a, b = 1, c = 2) a + b + c
+module top();
+  assign x = `ADD(y);
+  assign x = `ADD(y, , 3);
+  assign x = `ADD(y, z, w);
+endmodule)");
+
+  EXPECT_EQ(res, R"(
+module top();
+  assign x = y + 1 + 2;
+  assign x = y + 1 + 3;
+  assign x = y + z + w;
+endmodule)");
+}
+
+TEST(PreprocessTest, TokenPastingExpansion) {
+  PreprocessHarness harness;
+  const std::string res = harness.preprocess(R"(
+`define CAT(a, b) a``b
+`define WRAP(n) pre_``n``_post
+module top();
+  logic `CAT(foo, bar);
+  logic `WRAP(sig);
+endmodule)");
+
+  EXPECT_EQ(res, R"(
+module top();
+  logic foobar;
+  logic pre_sig_post;
+endmodule)");
+}
+
+TEST(PreprocessTest, FormalNamedAfterEarlierActual) {
+  PreprocessHarness harness;
+  const std::string res = harness.preprocess(R"(
+`define SWAP(a, b) a b
+module top();
+  assign x = `SWAP(b, c);
+  assign x = `SWAP(c, d);
+endmodule)");
+
+  // Arguments are substituted one formal at a time, the value put in for a
+  // is replaced again when it is named after b.
+  EXPECT_EQ(res, R"(
+module top();
+  assign x = c c;
+  assign x = c d;
+endmodule)");
+}
+
 TEST(PreprocessTest, IfdefCodeSelectionIfBranch) {
   PreprocessHarness harness;
   const std::string res = harness.preprocess(R"(
@@ -175,5 +336,197 @@ module top();
 endmodule)");
 }
 
+TEST(PreprocessTest, SharedBaseMacroLayer) {
+  CompilationUnit base(false);
+  PreprocessHarness baseHarness;
+  baseHarness.preprocess("`define WIDTH 8", &base);
+
+  CompilationUnit unit1(true);
+  CompilationUnit unit2(true);
+  unit1.setBaseMacros(&base.getMacros());
+  unit2.setBaseMacros(&base.getMacros());
+
+  // A local definition shadows the base layer for its own unit only.
+  PreprocessHarness harness1;
+  harness1.preprocess("`define WIDTH 16", &unit1);
+  EXPECT_EQ(harness1.preprocess("assign a = `WIDTH;", &unit1),
+            "assign a = 16;");
+  PreprocessHarness harness2;
+  EXPECT_EQ(harness2.preprocess("assign a = `WIDTH;", &unit2),
+            "assign a = 8;");
+  EXPECT_TRUE(unit2.getMacros().empty());
+
+  unit1.deleteAllMacros();
+  EXPECT_EQ(unit1.getMacroInfo("WIDTH"), nullptr);
+  EXPECT_NE(unit2.getMacroInfo("WIDTH"), nullptr);
+  unit2.deleteMacro("WIDTH");
+  EXPECT_EQ(unit2.getMacroInfo("WIDTH"), nullptr);
+  EXPECT_NE(base.getMacroInfo("WIDTH"), nullptr);
+}
+
+TEST(PreprocessTest, SpeculativeCompilationUnit) {
+  CompilationUnit actual(false);
+  CompilationUnit first(false);
+  CompilationUnit second(false);
+  CompilationUnit third(false);
+  first.setSpeculative();
+  second.setSpeculative();
+  third.setSpeculative();
+
+  PreprocessHarness harness1;
+  harness1.preprocess("`define WIDTH 8", &first);
+  PreprocessHarness harness2;
+  harness2.preprocess("`ifdef WIDTH\nassign a = 1;\n`endif", &second);
+  PreprocessHarness harness3;
+  harness3.preprocess("`define DEPTH 4\nassign b = `DEPTH;", &third);
+
+  EXPECT_TRUE(first.isSpeculationValid(actual));
+  first.replaySpeculation(&actual);
+  EXPECT_NE(actual.getMacroInfo("WIDTH"), nullptr);
+
+  // WIDTH was predicted undefined
+  EXPECT_FALSE(second.isSpeculationValid(actual));
+  // DEPTH is defined before being used
+  EXPECT_TRUE(third.isSpeculationValid(actual));
+}
+
+TEST(PreprocessTest, SpeculativePreprocessingMatchesSerial) {
+  const fs::path kBaseDir = fs::path(testing::TempDir()) / "specpp";
+  std::error_code ec;
+  fs::remove_all(kBaseDir, ec);
+  fs::create_directories(kBaseDir, ec);
+  std::unique_ptr<FileSystem> fileSystem(new TestFileSystem(kBaseDir));
+
+  // defs.sv invalidates the speculation of use.sv and redef.sv, the other
+  // files do not depend on the earlier ones.
+  const std::vector<std::pair<std::string, std::string>> sources{
+      {"defs.sv", "`define WIDTH 8\n`define ADD(a, b) a + b\n"},
+      {"plain.sv", "module plain; wire [3:0] w; endmodule\n"},
+      {"use.sv",
+       "module m_use; wire [`WIDTH-1:0] w = `ADD(1, 2); endmodule\n"},
+      {"local.sv",
+       "`define DEPTH 4\nmodule m_local; wire [`DEPTH:0] w; endmodule\n"},
+      {"redef.sv",
+       "`ifdef WIDTH\n`undef WIDTH\n`endif\n`define WIDTH 16\n"
+       "module redef; wire [`WIDTH-1:0] w; endmodule\n"},
+      {"after.sv", "module after; wire [`WIDTH-1:0] w; endmodule\n"}};
+  SymbolTable symbolTable;
+  std::vector<fs::path> files;
+  for (const auto &[name, content] : sources) {
+    const fs::path file = kBaseDir / name;
+    const PathId fileId = fileSystem->toPathId(file.string(), &symbolTable);
+    std::ostream &strm = fileSystem->openForWrite(fileId);
+    strm << content;
+    fileSystem->close(strm);
+    files.emplace_back(file);
+  }
+
+  const std::vector<std::string> serial = PreprocessUnit(files, false);
+  const std::vector<std::string> speculative = PreprocessUnit(files, true);
+  ASSERT_EQ(serial.size(), files.size() + 1);
+  EXPECT_EQ(speculative, serial);
+  EXPECT_NE(serial[5].find("[16-1:0]"), std::string::npos);
+
+  fs::remove_all(kBaseDir, ec);
+}
+
+TEST(PreprocessTest, MacroExpanderPlainBodies) {
+  ExpectSameAsGrammar(R"(
+`define WIDTH 8
+`define DECL(n) logic [`WIDTH-1:0] n = 'h1F
+`define PAIR(n) `DECL(n``_a); `DECL(n``_b)
+`define MSG(s) $display(`"s`", "`WIDTH")
+module top();
+  `PAIR(sig);
+  initial #`WIDTH `MSG(done);
+endmodule)");
+}
+
+TEST(PreprocessTest, MacroExpanderDirectivesInBody) {
+  ExpectSameAsGrammar(R"(
+`define WIDTH 8
+`define HERE `WIDTH + `__LINE__
+`define DROP(a) a `undef WIDTH
+module top();
+  assign a = `HERE;
+  assign b = `DROP(c);
+endmodule)");
+}
+
+TEST(PreprocessTest, MacroExpanderCommentsInBody) {
+  ExpectSameAsGrammar(R"(
+`define WIDTH 8
+`define BLOCK /* width */ `WIDTH
+`define LINE `WIDTH // width
+module top();
+  assign a = `BLOCK;
+  assign b = `LINE;
+endmodule)");
+}
+
+TEST(PreprocessTest, MacroExpanderEscapesInBody) {
+  ExpectSameAsGrammar(R"(
+`define WIDTH 8
+`define ESCID \esc_id `WIDTH
+`define CONT `WIDTH + \
+  1
+module top();
+  assign a = `ESCID;
+  assign b = `CONT;
+endmodule)");
+}
+
+TEST(PreprocessTest, MacroExpanderUndefinedMacroInBody) {
+  ExpectSameAsGrammar(R"(
+`define UNDEF `NOT_DEFINED + 1
+module top();
+  assign a = `UNDEF;
+endmodule)");
+}
+
+TEST(PreprocessTest, MacroExpanderMacroInArguments) {
+  ExpectSameAsGrammar(R"(
+`define WIDTH 8
+`define ID(x) x
+`define NESTED `ID(`WIDTH)
+module top();
+  assign a = `NESTED;
+endmodule)");
+}
+
+TEST(PreprocessTest, MacroExpanderTimescaleInBody) {
+  ExpectSameAsGrammar(R"(
+`define WIDTH 8
+`define DELAY #10ns/1ps `WIDTH
+module top();
+  assign a = `DELAY;
+endmodule)");
+}
+
+TEST(PreprocessTest, MacroExpanderMultiLineNoArgs) {
+  const std::vector<IncludeFileInfo> infos = ExpectSameAsGrammar(R"(
+`define LINES first \
+  second
+`define OUTER `LINES
+module top();
+  assign a =   `OUTER;
+endmodule)");
+
+  // The POP record of a no-arg macro starts at the column of its PUSH
+  int32_t pops = 0;
+  for (const IncludeFileInfo &info : infos) {
+    if ((info.m_context != IncludeFileInfo::Context::MACRO) ||
+        (info.m_action != IncludeFileInfo::Action::POP)) {
+      continue;
+    }
+    ++pops;
+    ASSERT_GE(info.m_indexOpening, 0);
+    ASSERT_LT(static_cast<size_t>(info.m_indexOpening), infos.size());
+    EXPECT_EQ(info.m_originalStartColumn,
+              infos[info.m_indexOpening].m_originalStartColumn);
+  }
+  EXPECT_GT(pops, 0);
+}
+
 }  // namespace
 }  // namespace SURELOG
@@ -46,6 +46,7 @@ std::string PreprocessHarness::preprocess(std::string_view content,
                : PreprocessFile::SpecialInstructions::DontPersist);
   CompilationUnit unit(false);
   CommandLineParser clp(&m_errors, &m_symbols, false, false);
+  clp.setMacroExpander(m_macroExpander);
   Library lib("work", &m_symbols);
   Compiler compiler(&clp, &m_errors, &m_symbols);
   CompileSourceFile csf(BadPathId, &clp, &m_errors, &compiler, &m_symbols,
@@ -57,6 +58,10 @@ std::string PreprocessHarness::preprocess(std::string_view content,
   if (!pp.preprocess()) {
     result = "ERROR_PP";
   }
+  m_includeFileInfos.clear();
+  for (const IncludeFileInfo& info : pp.getIncludeFileInfo()) {
+    m_includeFileInfos.emplace_back(info);
+  }
   if (m_errors.hasFatalErrors()) {
     result = "ERROR_PP";
   }
@@ -688,7 +688,7 @@ void SV3_1aPpTreeShapeListener::enterMacroInstanceNoArgs(
         unsigned int lineSum = m_pp->getSumLineCount() + 1;
         int closingIndex = m_pp->getSourceFile()->addIncludeFileInfo(
             IncludeFileInfo::Context::MACRO, line, BadSymbolId, fileId, lineSum,
-            startLineCol.first,
+            startLineCol.second,
             lineSum + (endLineCol.first - startLineCol.first),
             endLineCol.second, IncludeFileInfo::Action::POP, openingIndex, 0);
         if (openingIndex >= 0) {
@@ -922,8 +922,8 @@ void SV3_1aPpTreeShapeListener::enterString(
       std::string stringData = stringContent;
       stringData.erase(0, 1);
       stringData.erase(stringData.end() - 1, stringData.end());
-      stringData = std::regex_replace(stringData, std::regex("``.``"), ".");
-      stringData = std::regex_replace(stringData, std::regex("``-``"), "-");
+      stringData = StringUtils::replaceAll(stringData, "``.``", ".");
+      stringData = StringUtils::replaceAll(stringData, "``-``", "-");
       std::string mem = stringData;
       stringData = m_pp->evaluateMacroInstance(
           stringData, m_pp, lineCol.first,
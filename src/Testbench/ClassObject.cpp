@@ -26,7 +26,7 @@
 
 namespace SURELOG {
 
-bool ClassObject::setValue(const std::string& property, Value* value) {
+bool ClassObject::setValue(std::string_view property, Value* value) {
   PropertyValueMap::iterator itr = m_properties.find(property);
   if (itr == m_properties.end()) {
     Property* prop = m_class->getProperty(property);
@@ -40,7 +40,7 @@ bool ClassObject::setValue(const std::string& property, Value* value) {
   return true;
 }
 
-Value* ClassObject::getValue(const std::string& property) const {
+Value* ClassObject::getValue(std::string_view property) const {
   auto found = m_properties.find(property);
   return found == m_properties.end() ? nullptr : found->second.second;
 }
@@ -78,11 +78,20 @@ std::vector<antlr4::tree::ParseTree*> ParseUtils::getTopTokenList(
 void ParseUtils::tokenizeAtComma(
     std::vector<std::string>& actualArgs,
     const std::vector<antlr4::tree::ParseTree*>& tokens) {
+  std::vector<std::string> texts;
+  texts.reserve(tokens.size());
+  for (antlr4::tree::ParseTree* token : tokens) {
+    texts.emplace_back(token->getText());
+  }
+  tokenizeAtComma(actualArgs, texts);
+}
+
+void ParseUtils::tokenizeAtComma(std::vector<std::string>& actualArgs,
+                                 const std::vector<std::string>& tokens) {
   bool notEmpty = false;
   std::vector<std::string> tmpArgs;
   unsigned int topIndex = 0;
-  for (antlr4::tree::ParseTree* token : tokens) {
-    const std::string s = token->getText();
+  for (const std::string& s : tokens) {
     if (s == ",") {
       tmpArgs.push_back(",");
       topIndex++;
@@ -153,8 +153,7 @@ std::vector<std::string_view>& StringUtils::tokenizeBalanced(
   return result;
 }
 
-// Remove line feed unless it is escaped with backslash.
-static std::string removeLF(std::string_view st) {
+std::string StringUtils::removeLF(std::string_view st) {
   if (st.find('\n') == std::string::npos) return std::string(st);
 
   std::string result;
@@ -169,11 +168,12 @@ static std::string removeLF(std::string_view st) {
 void StringUtils::replaceInTokenVector(
     std::vector<std::string>& tokens,
     const std::vector<std::string_view>& pattern, std::string_view news) {
-  unsigned int patternIndex = 0;
   std::vector<std::string>::iterator itr;
   bool more = true;
   while (more) {
     more = false;
+    // A partial match does not carry over to the next pass
+    unsigned int patternIndex = 0;
     for (itr = tokens.begin(); itr != tokens.end(); itr++) {
       if (patternIndex > 0 && *itr != pattern[patternIndex])
         patternIndex = 0;  // Restart
@@ -244,12 +244,19 @@ std::string_view StringUtils::leaf(std::string_view str) {
 
 std::string StringUtils::replaceAll(std::string_view str, std::string_view from,
                                     std::string_view to) {
-  size_t start_pos = 0;
-  std::string result(str);
-  while ((start_pos = result.find(from, start_pos)) != std::string::npos) {
-    result.replace(start_pos, from.length(), to);
-    start_pos += to.length();  // Handles case where 'to' is a substr of 'from'
+  size_t start_pos = from.empty() ? std::string_view::npos : str.find(from);
+  if (start_pos == std::string_view::npos) return std::string(str);
+  // Single pass copy, replacing in place is quadratic with many matches
+  std::string result;
+  result.reserve(str.size());
+  size_t copied = 0;
+  while (start_pos != std::string_view::npos) {
+    result.append(str.data() + copied, start_pos - copied);
+    result.append(to);
+    copied = start_pos + from.length();
+    start_pos = str.find(from, copied);
   }
+  result.append(str.data() + copied, str.size() - copied);
   return result;
 }
 
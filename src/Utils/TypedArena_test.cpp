@@ -0,0 +1,79 @@
+/*
+ Copyright 2020 The Surelog Team.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include <Surelog/Utils/TypedArena.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace SURELOG {
+namespace {
+struct Tracked {
+  Tracked(std::vector<int>* destroyed, int id, std::string name)
+      : m_destroyed(destroyed), m_id(id), m_name(std::move(name)) {}
+  ~Tracked() { m_destroyed->push_back(m_id); }
+
+  std::vector<int>* const m_destroyed;
+  const int m_id;
+  const std::string m_name;
+};
+}  // namespace
+
+TEST(TypedArenaTest, MakeAndStats) {
+  std::vector<int> destroyed;
+  TypedArena<Tracked> arena;
+  EXPECT_EQ(arena.getObjectCount(), 0u);
+  EXPECT_EQ(arena.getBlockCount(), 0u);
+
+  const size_t count = TypedArena<Tracked>::kObjectsPerBlock + 3;
+  std::vector<Tracked*> objects;
+  for (size_t i = 0; i < count; ++i) {
+    objects.push_back(arena.make(&destroyed, (int)i, std::to_string(i)));
+  }
+  EXPECT_EQ(arena.getObjectCount(), count);
+  EXPECT_EQ(arena.getBlockCount(), 2u);
+  EXPECT_EQ(arena.getReservedBytes(),
+            2 * TypedArena<Tracked>::kObjectsPerBlock * sizeof(Tracked));
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(objects[i]->m_id, (int)i);
+    EXPECT_EQ(objects[i]->m_name, std::to_string(i));
+  }
+  EXPECT_TRUE(destroyed.empty());
+}
+
+TEST(TypedArenaTest, ClearDestroysInReverseOrder) {
+  std::vector<int> destroyed;
+  {
+    TypedArena<Tracked> arena;
+    const size_t count = TypedArena<Tracked>::kObjectsPerBlock + 1;
+    for (size_t i = 0; i < count; ++i) arena.make(&destroyed, (int)i, "");
+    arena.clear();
+    ASSERT_EQ(destroyed.size(), count);
+    for (size_t i = 0; i < count; ++i) {
+      EXPECT_EQ(destroyed[i], (int)(count - 1 - i));
+    }
+    EXPECT_EQ(arena.getObjectCount(), 0u);
+    EXPECT_EQ(arena.getBlockCount(), 0u);
+
+    // Usable again after clear, remaining objects go with the arena.
+    destroyed.clear();
+    arena.make(&destroyed, 42, "");
+  }
+  ASSERT_EQ(destroyed.size(), 1u);
+  EXPECT_EQ(destroyed[0], 42);
+}
+}  // namespace SURELOG
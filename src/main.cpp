@@ -56,9 +56,12 @@ constexpr std::string_view batch_opt = "-batch";
 constexpr std::string_view nostdout_opt = "-nostdout";
 constexpr std::string_view output_folder_opt = "-o";
 
+// In -diffcompunit mode, "diffUnitResult" is filled by the file unit
+// compilation and compared against by the all files compilation.
 unsigned int executeCompilation(
     int argc, const char** argv, bool diffCompMode, bool fileUnit,
-    SURELOG::ErrorContainer::Stats* overallStats = nullptr) {
+    SURELOG::ErrorContainer::Stats* overallStats = nullptr,
+    SURELOG::Report::Result* diffUnitResult = nullptr) {
   SURELOG::FileSystem* const fileSystem = SURELOG::FileSystem::getInstance();
   bool success = true;
   bool noFatalErrors = true;
@@ -113,10 +116,14 @@ unsigned int executeCompilation(
     std::cout << "Command result: " << result << std::endl;
   }
   clp->logFooter();
-  if (diffCompMode && fileUnit) {
+  if (diffCompMode && fileUnit && diffUnitResult) {
+    SURELOG::Report::collectResult(errors, *diffUnitResult);
+  } else if (diffCompMode && diffUnitResult) {
+    SURELOG::Report::Result allResult;
+    SURELOG::Report::collectResult(errors, allResult);
     SURELOG::Report* report = new SURELOG::Report();
-    std::pair<bool, bool> results =
-        report->makeDiffCompUnitReport(clp, symbolTable);
+    std::pair<bool, bool> results = report->makeDiffCompUnitReport(
+        clp, symbolTable, *diffUnitResult, allResult);
     success = results.first;
     noFatalErrors = results.second;
     delete report;
@@ -269,27 +276,14 @@ int main(int argc, const char** argv) {
 
   switch (mode) {
     case DIFF: {
-#if (defined(_MSC_VER) || defined(__MINGW32__) || defined(__CYGWIN__))
-      // REVISIT: Windows doesn't have the concept of forks!
-      // Implement it sequentially for now and optimize it if this
-      // proves to be a bottleneck (preferably, implemented as a
-      // cross platform solution).
-      executeCompilation(argc, argv, true, false);
-      codedReturn = executeCompilation(argc, argv, true, true);
-#else
-      pid_t pid = fork();
-      if (pid == 0) {
-        // child process
-        executeCompilation(argc, argv, true, false);
-      } else if (pid > 0) {
-        // parent process
-        codedReturn = executeCompilation(argc, argv, true, true);
-      } else {
-        // fork failed
-        printf("fork() failed!\n");
-        return 1;
-      }
-#endif
+      // Both compilations run in this process, file unit first: the all
+      // files compilation reuses the file unit parse of every file that
+      // preprocessed to the same text (see ParseCache::restoreFromFileUnit).
+      SURELOG::Report::Result unitResult;
+      codedReturn =
+          executeCompilation(argc, argv, true, true, nullptr, &unitResult);
+      codedReturn |=
+          executeCompilation(argc, argv, true, false, nullptr, &unitResult);
       break;
     }
     case NORMAL: